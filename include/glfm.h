@@ -72,6 +72,23 @@
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
+
+// Subsystems that can be compiled out of Emscripten builds to reduce code size. If 0, the related functions are inline
+// stubs that report the feature as unavailable, so GLFM and the app must be compiled with the same values. The
+// GLFM_FEATURE_* options in CMakeLists.txt are defined for both.
+#ifndef GLFM_FEATURE_KEYBOARD
+#  define GLFM_FEATURE_KEYBOARD 1
+#endif
+#ifndef GLFM_FEATURE_CLIPBOARD
+#  define GLFM_FEATURE_CLIPBOARD 1
+#endif
+#ifndef GLFM_FEATURE_SENSORS
+#  define GLFM_FEATURE_SENSORS 1
+#endif
+#if !defined(__EMSCRIPTEN__) && !(GLFM_FEATURE_KEYBOARD && GLFM_FEATURE_CLIPBOARD && GLFM_FEATURE_SENSORS)
+#  error GLFM_FEATURE_KEYBOARD, GLFM_FEATURE_CLIPBOARD, and GLFM_FEATURE_SENSORS can only be disabled on Emscripten
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -115,6 +132,16 @@ typedef enum {
     GLFMSwapBehaviorBufferPreserved,
 } GLFMSwapBehavior;
 
+/// Defines which GPU to prefer on systems with more than one. See ``glfmSetPowerPreference``.
+typedef enum {
+    /// Uses the platform default. See ``glfmSetPowerPreference``.
+    GLFMPowerPreferencePlatformDefault,
+    /// Prefers the GPU that uses less power, like an integrated GPU.
+    GLFMPowerPreferenceLowPower,
+    /// Prefers the fastest GPU, like a discrete GPU.
+    GLFMPowerPreferenceHighPerformance,
+} GLFMPowerPreference;
+
 /// Defines whether system UI chrome (status bar, navigation bar) is shown.
 typedef enum {
     /// Displays the app with the navigation bar.
@@ -161,6 +188,16 @@ typedef enum {
     GLFMUserInterfaceOrientationLandscape GLFM_DEPRECATED("Replaced with GLFMInterfaceOrientationLandscape") = GLFMInterfaceOrientationLandscape,
 } GLFMUserInterfaceOrientation GLFM_DEPRECATED("Replaced with GLFMInterfaceOrientation");
 
+/// A rotation applied to the surface, relative to the native orientation of the display panel.
+///
+/// See ``glfmGetPreTransform``.
+typedef enum {
+    GLFMSurfaceTransformIdentity,
+    GLFMSurfaceTransformRotate90,
+    GLFMSurfaceTransformRotate180,
+    GLFMSurfaceTransformRotate270,
+} GLFMSurfaceTransform;
+
 typedef enum {
     GLFMTouchPhaseHover,
     GLFMTouchPhaseBegan,
@@ -381,6 +418,17 @@ typedef enum {
     GLFMSensorRotationMatrix,
 } GLFMSensor;
 
+/// How the rotation sensor is computed. See ``glfmSetSensorFusionMode``.
+typedef enum {
+    /// Use the platform's rotation sensor if the device has one. Otherwise, derive the rotation from the
+    /// accelerometer, gyroscope, and magnetometer.
+    GLFMSensorFusionModeAutomatic,
+    /// Always derive the rotation from the accelerometer, gyroscope, and magnetometer.
+    GLFMSensorFusionModeAlways,
+    /// Only use the platform's rotation sensor.
+    GLFMSensorFusionModeDisabled,
+} GLFMSensorFusionMode;
+
 typedef enum {
     GLFMHapticFeedbackLight,
     GLFMHapticFeedbackMedium,
@@ -403,6 +451,8 @@ GLFM_DEPRECATED("See glfmSetRenderFunc and glfmSwapBuffers");
 
 /// Callback function when mouse or touch events occur. See ``glfmSetTouchFunc``.
 ///
+/// When a hovering mouse leaves the view, ``GLFMTouchPhaseCancelled`` is sent at its last hover position.
+///
 /// - Parameters:
 ///   - touch: The touch number (zero for primary touch, 1+ for multitouch), or the mouse button number (zero for the
 ///            primary button, 1 for secondary, etc.).
@@ -491,6 +541,16 @@ typedef void (*GLFMMemoryWarningFunc)(GLFMDisplay *display);
 /// before the page is unloaded.
 typedef void (*GLFMAppFocusFunc)(GLFMDisplay *display, bool focused);
 
+/// The state of a touch or mouse pointer. See ``glfmGetTouchState``.
+typedef struct {
+    /// The touch, the same value as in ``GLFMTouchFunc``.
+    int touch;
+    /// The phase of the most recent event of the touch.
+    GLFMTouchPhase phase;
+    /// The most recent position of the touch.
+    double x, y;
+} GLFMTouchState;
+
 /// The result used in the hardware sensor callback. See ``glfmSetSensorFunc``.
 ///
 /// The `vector` is used for all sensor types except for `GLFMSensorRotationMatrix`,
@@ -517,6 +577,28 @@ typedef struct {
 /// Callback function when sensor events occur. See ``glfmSetSensorFunc``.
 typedef void (*GLFMSensorFunc)(GLFMDisplay *display, GLFMSensorEvent event);
 
+/// Callback function with every sensor sample received since the last callback, in order.
+/// See ``glfmSetSensorBatchFunc``.
+///
+/// The `events` pointer is only valid during the callback.
+typedef void (*GLFMSensorBatchFunc)(GLFMDisplay *display, const GLFMSensorEvent *events, int count);
+
+/// Callback function to create an OpenGL resource (like a buffer, texture, or program) from its source data.
+/// See ``glfmAddResource``.
+///
+/// The `data` pointer is GLFM's copy of the data given to ``glfmAddResource``.
+typedef void (*GLFMResourceCreateFunc)(GLFMDisplay *display, const void *data, size_t size, void *userData);
+
+/// A rectangle, in pixels. The origin is the top-left corner of the display.
+///
+/// See ``glfmSwapBuffersWithDamage``.
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} GLFMRect;
+
 // MARK: - Functions
 
 /// Main entry point for a GLFM app.
@@ -558,6 +640,46 @@ void *glfmGetUserData(const GLFMDisplay *display);
 ///                    must happen in application code.
 void glfmSwapBuffers(GLFMDisplay *display);
 
+/// Swap buffers, presenting only the areas of the display that changed since the last frame.
+///
+/// The compositor may skip the areas outside of the `rects`, which saves power and memory bandwidth when only a
+/// small part of the display changes each frame. The contents outside of the `rects` must still be valid, so use
+/// ``glfmGetBufferAge`` to know which areas of the buffer must be redrawn.
+///
+/// If `rects` is `NULL` or `count` is zero, the entire display is presented, like ``glfmSwapBuffers``.
+///
+/// - Android: Uses `EGL_KHR_swap_buffers_with_damage` (or `EGL_EXT_swap_buffers_with_damage`) when available.
+///
+/// - Emscripten, Apple platforms: The entire display is presented, like ``glfmSwapBuffers``.
+void glfmSwapBuffersWithDamage(GLFMDisplay *display, const GLFMRect *rects, int count);
+
+/// Sets the region of the current buffer that will be rendered to this frame.
+///
+/// This function must be called in the ``GLFMRenderFunc`` before any rendering, and after ``glfmGetBufferAge``
+/// (if used). The `rects` should include the damage of this frame plus the damage of the previous frames, according to
+/// the buffer age. The GPU may skip loading and storing pixels outside of the region.
+///
+/// - Android: Uses `EGL_KHR_partial_update` when available. Otherwise, this function does nothing.
+///
+/// - Emscripten, Apple platforms: This function does nothing.
+void glfmSetDamageRegion(GLFMDisplay *display, const GLFMRect *rects, int count);
+
+/// Gets the age of the current back buffer, in frames.
+///
+/// An age of `1` means the buffer contains the contents of the previous frame, `2` means the frame before that, and so
+/// on. An age of `0` means the contents of the buffer are undefined, and the entire display must be redrawn.
+///
+/// This function should be called in the ``GLFMRenderFunc`` before any rendering.
+///
+/// - Android: Uses `EGL_EXT_buffer_age` or `EGL_KHR_partial_update` when available. Otherwise, returns `0`.
+///
+/// - Emscripten: Returns `1` if the swap behavior is `GLFMSwapBehaviorBufferPreserved` (see ``glfmSetSwapBehavior``),
+///               except for the first frame after the canvas is resized or the WebGL context is restored. Otherwise,
+///               returns `0`.
+///
+/// - Apple platforms: Always returns `0`.
+int glfmGetBufferAge(GLFMDisplay *display);
+
 /// *Deprecated:* Use ``glfmGetSupportedInterfaceOrientation``.
 GLFMUserInterfaceOrientation glfmGetUserInterfaceOrientation(GLFMDisplay *display)
 GLFM_DEPRECATED("Replaced with glfmGetSupportedInterfaceOrientation");
@@ -586,6 +708,38 @@ void glfmSetSupportedInterfaceOrientation(GLFMDisplay *display, GLFMInterfaceOri
 ///   `GLFMInterfaceOrientationUnknown`.
 GLFMInterfaceOrientation glfmGetInterfaceOrientation(const GLFMDisplay *display);
 
+/// Sets whether the app renders in the native orientation of the display panel (Android only).
+///
+/// When the interface orientation differs from the panel's native orientation, the system compositor may need an
+/// extra pass to rotate each frame. When pre-rotation is enabled, the surface is created in the panel's native
+/// orientation, and the app is expected to apply the matrix from ``glfmGetPreTransform`` to its projection.
+///
+/// With pre-rotation, ``glfmGetDisplaySize``, touch locations, and chrome insets stay in the logical (rotated)
+/// space. However, for a 90 or 270 degree transform, the width and height of the framebuffer are swapped, so the
+/// viewport and scissor rectangles must be transformed too.
+///
+/// Defaults to `false`.
+void glfmSetPreRotationEnabled(GLFMDisplay *display, bool enabled);
+
+/// Returns `true` if pre-rotation is enabled.
+bool glfmGetPreRotationEnabled(const GLFMDisplay *display);
+
+/// Gets the surface transform that avoids a rotation pass in the system compositor, based on the current interface
+/// orientation.
+///
+/// - Android: This is the equivalent of the `ANativeWindow` transform hint.
+///
+/// - Emscripten, Apple platforms: Always returns `GLFMSurfaceTransformIdentity`.
+GLFMSurfaceTransform glfmGetSurfaceTransformHint(const GLFMDisplay *display);
+
+/// Gets the transform currently applied to the surface, and its matrix.
+///
+/// The `matrix` is a column-major 4x4 matrix that rotates clip space by the transform. Multiply it with the app's
+/// projection matrix (`preTransform * projection`). The `matrix` parameter may be `NULL`.
+///
+/// Returns `GLFMSurfaceTransformIdentity` if pre-rotation is disabled or not supported.
+GLFMSurfaceTransform glfmGetPreTransform(const GLFMDisplay *display, float matrix[16]);
+
 /// Gets the display size, in pixels.
 ///
 /// The arguments for the `width` and `height` parameters may be `NULL`.
@@ -623,24 +777,189 @@ void glfmSetDisplayChrome(GLFMDisplay *display, GLFMUserInterfaceChrome uiChrome
 /// The return value is not valid until the surface is created.
 GLFMRenderingAPI glfmGetRenderingAPI(const GLFMDisplay *display);
 
-/// Sets the swap behavior for newly created surfaces (Android only).
+/// Sets the swap behavior for newly created surfaces (Android and Emscripten only).
 ///
 /// In order to take effect, the behavior should be set before the surface is created, preferable at the very beginning
 /// of the ``glfmMain`` function.
+///
+/// - Emscripten: `GLFMSwapBehaviorBufferPreserved` sets the WebGL `preserveDrawingBuffer` context attribute.
 void glfmSetSwapBehavior(GLFMDisplay *display, GLFMSwapBehavior behavior);
 
 /// Returns the swap buffer behavior.
 GLFMSwapBehavior glfmGetSwapBehavior(const GLFMDisplay *display);
 
+/// Sets which GPU to prefer for newly created surfaces (Emscripten only).
+///
+/// This function should be called in ``glfmMain``.
+///
+/// - Emscripten: Sets the WebGL `powerPreference` context attribute. `GLFMPowerPreferencePlatformDefault` requests
+///               `high-performance`.
+void glfmSetPowerPreference(GLFMDisplay *display, GLFMPowerPreference powerPreference);
+
+/// Returns the GPU power preference. See ``glfmSetPowerPreference``.
+GLFMPowerPreference glfmGetPowerPreference(const GLFMDisplay *display);
+
+/// Sets whether surface creation fails if the system would use a much slower renderer, like a software renderer,
+/// instead of the GPU (Emscripten only). If surface creation fails, ``GLFMSurfaceErrorFunc`` is called.
+///
+/// Defaults to `false`. This function should be called in ``glfmMain``.
+///
+/// - Emscripten: Sets the WebGL `failIfMajorPerformanceCaveat` context attribute.
+void glfmSetFailIfMajorPerformanceCaveat(GLFMDisplay *display, bool fail);
+
+/// Returns `true` if surface creation fails when the system would use a much slower renderer.
+bool glfmGetFailIfMajorPerformanceCaveat(const GLFMDisplay *display);
+
+/// Sets whether the surface is created for low-latency rendering (Emscripten only).
+///
+/// Low latency rendering is useful for drawing apps, where the content should follow the pointer as closely as
+/// possible. The display may tear. For best results, use an opaque color format (``GLFMColorFormatRGB565``).
+///
+/// Defaults to `false`. This function should be called in ``glfmMain``.
+///
+/// - Emscripten: Requests a `desynchronized` WebGL context, which bypasses the compositor queue where supported.
+void glfmSetLowLatencyEnabled(GLFMDisplay *display, bool enabled);
+
+/// Returns `true` if the surface is created for low-latency rendering. See ``glfmSetLowLatencyEnabled``.
+bool glfmGetLowLatencyEnabled(const GLFMDisplay *display);
+
+/// Sets the OpenGL extensions to enable when the surface is created (Emscripten only).
+///
+/// The names are copied. Names may be given with or without the `GL_` prefix (for example,
+/// `GL_OES_vertex_array_object` or `OES_vertex_array_object`). Unsupported extensions are ignored; use
+/// ``glfmIsExtensionSupported`` to check which extensions were enabled.
+///
+/// If this function is not called, a default set of performance-related extensions is enabled when available:
+/// instancing and vertex array objects (WebGL 1), 32-bit indices, compressed textures, timer queries, parallel shader
+/// compilation, and multi-draw. Call this function with a `count` of `0` to enable no extensions.
+///
+/// This function should be called in ``glfmMain``.
+///
+/// - Android, iOS, tvOS, macOS: This function does nothing. Supported extensions are always enabled.
+void glfmSetEnabledExtensions(GLFMDisplay *display, const char *const *extensions, int count);
+
+/// Sets whether the depth and stencil buffers are invalidated before each swap.
+///
+/// When enabled, ``glfmSwapBuffers`` (and ``glfmSwapBuffersWithDamage``) tell the driver that the contents of the
+/// depth and stencil buffers created from the ``GLFMDepthFormat`` and ``GLFMStencilFormat`` are no longer needed.
+/// On tile-based mobile GPUs, this avoids writing them back to memory every frame.
+///
+/// Only enable this if the app doesn't read the depth or stencil buffers from a previous frame.
+///
+/// Defaults to `false`.
+///
+/// - Android: Uses `glInvalidateFramebuffer` (OpenGL ES 3) or `glDiscardFramebufferEXT` (OpenGL ES 2). The default
+///            framebuffer (`0`) must be bound when swapping; otherwise, the bound framebuffer's attachments are
+///            invalidated instead.
+///
+/// - Apple platforms: The depth and stencil buffers are always discarded, regardless of this setting.
+///
+/// - Emscripten: This setting has no effect. The browser discards the drawing buffer after compositing.
+void glfmSetDepthStencilInvalidationEnabled(GLFMDisplay *display, bool enabled);
+
+/// Returns `true` if the depth and stencil buffers are invalidated before each swap.
+bool glfmGetDepthStencilInvalidationEnabled(const GLFMDisplay *display);
+
+/// Sets whether the OpenGL context is preserved when the activity is destroyed (Android only).
+///
+/// The EGL surface is always released when the native window is destroyed (for example, when the app is paused), and
+/// the OpenGL context is kept in that case whether or not this option is enabled.
+///
+/// When enabled, only the EGL surface is also released when the activity is destroyed and when the app's thread exits.
+/// The EGLDisplay and EGLContext are never terminated, so all OpenGL objects stay alive, and a recreated activity
+/// continues rendering without a ``GLFMSurfaceDestroyedFunc`` / ``GLFMSurfaceCreatedFunc`` cycle. Unknown EGL errors
+/// are first handled by recreating the EGL surface only, instead of the whole EGL state.
+///
+/// A real context loss (`EGL_CONTEXT_LOST`) is still reported via ``GLFMSurfaceDestroyedFunc`` followed by
+/// ``GLFMSurfaceCreatedFunc``, so apps must continue to handle those callbacks.
+///
+/// The context keeps its GPU memory for the lifetime of the process.
+///
+/// Defaults to `false`. This function should be called in ``glfmMain``.
+void glfmSetContextPreservationEnabled(GLFMDisplay *display, bool enabled);
+
+/// Returns `true` if the OpenGL context is preserved when the activity is destroyed.
+bool glfmGetContextPreservationEnabled(const GLFMDisplay *display);
+
+/// Sets the render scale, which renders into a smaller backbuffer that the system compositor scales up to fill the
+/// display.
+///
+/// A scale of `1.0` (the default) renders at the full display resolution. A scale of `0.5` renders one quarter of the
+/// pixels. The value is clamped to the range `0.25` to `1.0`.
+///
+/// The new size takes effect on the next frame, and is reported with ``GLFMSurfaceResizedFunc``. The values returned
+/// from ``glfmGetDisplaySize`` and ``glfmGetDisplayScale``, touch locations, and chrome insets are all in backbuffer
+/// pixels.
+///
+/// When automatic render scale is enabled, this value is the maximum scale.
+///
+/// - iOS, tvOS, macOS: Not implemented; the display is always rendered at full resolution.
+void glfmSetRenderScale(GLFMDisplay *display, double scale);
+
+/// Gets the current render scale.
+///
+/// When automatic render scale is enabled, this is the scale currently chosen by GLFM.
+double glfmGetRenderScale(const GLFMDisplay *display);
+
+/// Sets whether GLFM automatically adjusts the render scale based on the measured frame time.
+///
+/// When enabled, the render scale is lowered (down to `0.5`) when frames take longer than the display refresh
+/// interval, and raised (up to the value set with ``glfmSetRenderScale``) when rendering keeps up. This is useful for
+/// fill-rate limited apps on high-DPI devices.
+///
+/// Each change resizes the backbuffer, so the app should use the width and height from ``GLFMSurfaceResizedFunc`` or
+/// ``glfmGetDisplaySize`` when setting the viewport.
+///
+/// - Emscripten: Browsers don't expose the refresh interval, so it is estimated from the frame intervals. The render
+///               scale is not adjusted until the first estimate is available, after about 120 frames.
+/// - iOS, tvOS, macOS: Not implemented.
+void glfmSetAutomaticRenderScaleEnabled(GLFMDisplay *display, bool enabled);
+
+/// Returns `true` if the render scale is adjusted automatically.
+bool glfmGetAutomaticRenderScaleEnabled(const GLFMDisplay *display);
+
+/// Sets how many times per second ``GLFMRenderFunc`` is called while the app is hidden. By default, the rate is `0`,
+/// and ``GLFMRenderFunc`` is not called while the app is hidden.
+///
+/// A low rate (for example, `1`) is useful for apps that need to keep updating state in the background.
+///
+/// - Emscripten: The app is hidden when the page is hidden, like when it is in a background tab or the browser is
+///               minimized. The main loop is paused while hidden, or runs on a timer at this rate. Browsers may limit
+///               timers in background tabs to a lower rate.
+///
+/// - Android, iOS, tvOS, macOS: This function does nothing.
+void glfmSetHiddenFrameRate(GLFMDisplay *display, double framesPerSecond);
+
+/// Gets the rate at which ``GLFMRenderFunc`` is called while the app is hidden. See ``glfmSetHiddenFrameRate``.
+double glfmGetHiddenFrameRate(const GLFMDisplay *display);
+
 /// Gets the address of the specified function.
 GLFMProc glfmGetProcAddress(const char *functionName);
 
+/// Returns `true` if the OpenGL extension (for example, `GL_OES_vertex_array_object`) is supported and can be used.
+///
+/// The list of extensions is queried once and cached until the surface is destroyed. This function must be called
+/// while the surface exists, like from ``GLFMSurfaceCreatedFunc`` or ``GLFMRenderFunc``.
+///
+/// - Emscripten: Only extensions enabled when the surface was created are reported (see ``glfmSetEnabledExtensions``).
+///               Names may be given with or without the `GL_` prefix.
+///
+/// - Apple platforms: Returns `false` when using Metal.
+bool glfmIsExtensionSupported(GLFMDisplay *display, const char *extension);
+
 /// Gets whether there is currently text available in the system clipboard.
 ///
 /// - Emscripten: Returns true if the Clipboard API is available. It is not possible to know if text is available in the
 ///               system clipboard until it is requested.
 /// - tvOS: No clipboard API is available. Always returns false.
+#if GLFM_FEATURE_CLIPBOARD
 bool glfmHasClipboardText(const GLFMDisplay *display);
+#else
+static inline bool glfmHasClipboardText(const GLFMDisplay *display) {
+    (void)display;
+    return false;
+}
+#endif
 
 /// Requests the system clipboard text.
 ///
@@ -654,7 +973,15 @@ bool glfmHasClipboardText(const GLFMDisplay *display);
 /// - Emscripten: On some browsers, this function can only be called in an event handler, like ``GLFMTouchFunc`` or
 ///               ``GLFMKeyFunc``. Currently, Firefox does not support reading from the clipboard.
 /// - tvOS: No clipboard API is available. The `clipboardTextFunc` callback is invoked with a NULL string.
+#if GLFM_FEATURE_CLIPBOARD
 void glfmRequestClipboardText(GLFMDisplay *display, GLFMClipboardTextFunc clipboardTextFunc);
+#else
+static inline void glfmRequestClipboardText(GLFMDisplay *display, GLFMClipboardTextFunc clipboardTextFunc) {
+    if (clipboardTextFunc) {
+        clipboardTextFunc(display, NULL);
+    }
+}
+#endif
 
 /// Set the system clipboard text.
 ///
@@ -663,7 +990,15 @@ void glfmRequestClipboardText(GLFMDisplay *display, GLFMClipboardTextFunc clipbo
 /// - Parameters:
 ///   - string: A NULL-terminated UTF-8 string.
 /// - Returns: `true` on success, `false` otherwise.
+#if GLFM_FEATURE_CLIPBOARD
 bool glfmSetClipboardText(GLFMDisplay *display, const char *string);
+#else
+static inline bool glfmSetClipboardText(GLFMDisplay *display, const char *string) {
+    (void)display;
+    (void)string;
+    return false;
+}
+#endif
 
 /// Gets the value of the highest precision time available, in seconds.
 ///
@@ -739,10 +1074,72 @@ bool glfmGetMultitouchEnabled(const GLFMDisplay *display);
 /// Gets whether the display has touch capabilities.
 bool glfmHasTouch(const GLFMDisplay *display);
 
+/// Predicts the position of an active touch or mouse pointer at a time in the near future, like the time the next
+/// frame is expected to be displayed. Use it to reduce the apparent latency of inking and dragging.
+///
+/// The velocity is estimated with a least-squares fit of the recent positions of the pointer, and the prediction is
+/// limited to 50 milliseconds after the latest position. The `time` is in the same timebase as ``glfmGetTime``.
+///
+/// The `touch` is the same value as in ``GLFMTouchFunc``. Returns `false` if the touch is not active (for example,
+/// after ``GLFMTouchPhaseEnded``), in which case `x` and `y` are not modified.
+bool glfmGetPredictedTouch(const GLFMDisplay *display, int touch, double time, double *x, double *y);
+
+/// Delivers input that arrived since the frame started, so that a render function can use input received up to a few
+/// milliseconds before drawing (for example, to pan a camera).
+///
+/// Call this from the ``GLFMRenderFunc``. Pending touch and key events are sent to the ``GLFMTouchFunc`` and
+/// ``GLFMKeyFunc`` before this function returns, and touch moves held by touch coalescing are sent.
+///
+/// - Android: Pending input and sensor events are sent. Lifecycle changes still wait until the end of the frame. Has
+///            no effect outside of the ``GLFMRenderFunc``.
+/// - iOS, tvOS, macOS, and Emscripten: Input is delivered on the main thread between frames, so only touch moves held
+///                                     by touch coalescing are sent.
+void glfmLatchInput(GLFMDisplay *display);
+
+/// Gets the state of the active touches and mouse pointers, for apps that poll input once per frame instead of (or in
+/// addition to) using a ``GLFMTouchFunc``.
+///
+/// Up to `maxTouches` states are written to `touches`, ordered by touch. Returns the number of touches, which may be
+/// greater than `maxTouches`. The `touches` array may be `NULL` to only get the count.
+///
+/// A touch is active from ``GLFMTouchPhaseBegan`` (or ``GLFMTouchPhaseHover``) until ``GLFMTouchPhaseEnded`` or
+/// ``GLFMTouchPhaseCancelled``. A touch that ended is still included, with its final phase and position, until the
+/// next frame is drawn, so that a tap that begins and ends between frames is seen. Only the first 10 touches are
+/// tracked. The state is tracked whether or not a ``GLFMTouchFunc`` is set. See ``glfmSetInputStateTrackingEnabled``.
+int glfmGetTouchState(const GLFMDisplay *display, GLFMTouchState *touches, int maxTouches);
+
+/// Returns `true` if the key is currently down, for apps that poll input once per frame instead of (or in addition to)
+/// using a ``GLFMKeyFunc``.
+///
+/// The state is tracked whether or not a ``GLFMKeyFunc`` is set. See ``glfmSetInputStateTrackingEnabled``. All keys are
+/// considered up when the app loses focus.
+///
+/// - iOS and tvOS: Keys typed with the virtual keyboard are pressed and released immediately, so they are never
+///                 reported as down.
+#if GLFM_FEATURE_KEYBOARD
+bool glfmIsKeyDown(const GLFMDisplay *display, GLFMKeyCode keyCode);
+#else
+static inline bool glfmIsKeyDown(const GLFMDisplay *display, GLFMKeyCode keyCode) {
+    (void)display;
+    (void)keyCode;
+    return false;
+}
+#endif
+
 /// Checks if a hardware sensor is available.
 ///
-/// - Emscripten: Always returns `false`.
+/// - Emscripten: Returns `true` if the browser supports the DeviceMotion (accelerometer and gyroscope) or
+///   DeviceOrientation (rotation) events, even if the device does not have the hardware. The magnetometer is not
+///   available.
+#if GLFM_FEATURE_SENSORS
 bool glfmIsSensorAvailable(const GLFMDisplay *display, GLFMSensor sensor);
+#else
+static inline bool glfmIsSensorAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
+    (void)display;
+    (void)sensor;
+    return false;
+}
+#endif
 
 /// Sets the mouse cursor (only on platforms with a mouse).
 void glfmSetMouseCursor(GLFMDisplay *display, GLFMMouseCursor mouseCursor);
@@ -773,6 +1170,58 @@ glfmSetKeyboardVisibilityChangedFunc(GLFMDisplay *display, GLFMKeyboardVisibilit
 /// Sets the function to call when a mouse or touch event occurs.
 GLFMTouchFunc glfmSetTouchFunc(GLFMDisplay *display, GLFMTouchFunc touchFunc);
 
+/// Sets whether touch move events are coalesced. By default, touch coalescing is disabled.
+///
+/// When enabled, ``GLFMTouchPhaseMoved`` and ``GLFMTouchPhaseHover`` events are held until right before the next
+/// ``GLFMRenderFunc`` call, and only the latest position of each pointer is sent to the ``GLFMTouchFunc``. Began,
+/// ended, and cancelled events are always sent, in order, with any held move sent first. This reduces the number of
+/// callbacks for apps that only need the latest position of each pointer.
+///
+/// Every position is still used by ``glfmGetPredictedTouch``. Held events are treated as handled.
+void glfmSetTouchCoalescingEnabled(GLFMDisplay *display, bool enabled);
+
+/// Gets whether touch move events are coalesced. See ``glfmSetTouchCoalescingEnabled``.
+bool glfmGetTouchCoalescingEnabled(const GLFMDisplay *display);
+
+/// Sets whether input events are batched. By default, input batching is disabled.
+///
+/// When enabled, touch, mouse, wheel, and key events are recorded as they occur and sent to the app right before the
+/// next ``GLFMRenderFunc`` call, instead of being sent as they occur. This reduces overhead for apps that receive many
+/// events per frame.
+///
+/// Since events are sent after the browser has handled them, the return values of ``GLFMTouchFunc``,
+/// ``GLFMKeyFunc``, and ``GLFMMouseWheelFunc`` are ignored. Instead, the default action of touch and wheel events on
+/// the canvas is prevented if the app has a function for them, and the default action of key events is prevented if
+/// the app has a ``GLFMKeyFunc`` or ``GLFMCharFunc``, unless the control or meta key is down.
+///
+/// If too many events occur between frames, moves and wheel events are dropped first. If other events are dropped,
+/// all touches are cancelled and all keys are released. Events that occur while the page is hidden are discarded.
+///
+/// - Emscripten: When built with `GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS`, input events are always batched.
+///
+/// - Android, iOS, tvOS, macOS: This function does nothing.
+void glfmSetInputBatchingEnabled(GLFMDisplay *display, bool enabled);
+
+/// Gets whether input events are batched. See ``glfmSetInputBatchingEnabled``.
+bool glfmGetInputBatchingEnabled(const GLFMDisplay *display);
+
+/// Sets whether touch and key events are received for the polled input state (``glfmGetTouchState``,
+/// ``glfmGetPredictedTouch``, and ``glfmIsKeyDown``) even while the app has no function for them.
+///
+/// By default, input state tracking is enabled the first time one of those functions is called, so apps that don't
+/// poll input only receive the events they have a function for. Until then (or while disabled), the polled state is
+/// only updated while the app has a function for the events. Apps can enable it at startup so that the state is
+/// tracked from the first frame, or disable it so that polling doesn't enable it.
+///
+/// Events received only for the input state are not handled, so their default action is not prevented.
+///
+/// - Android, iOS, tvOS, macOS: Input events are always received, so this function does nothing.
+void glfmSetInputStateTrackingEnabled(GLFMDisplay *display, bool enabled);
+
+/// Gets whether touch and key events are received for the polled input state. See
+/// ``glfmSetInputStateTrackingEnabled``.
+bool glfmGetInputStateTrackingEnabled(const GLFMDisplay *display);
+
 /// Sets the function to call when a key event occurs.
 ///
 /// - iOS and tvOS: Key events require iOS 13.4 and tvOS 13.4. No repeated events (`GLFMKeyActionRepeated`) are sent.
@@ -841,8 +1290,139 @@ GLFMMouseWheelFunc glfmSetMouseWheelFunc(GLFMDisplay *display, GLFMMouseWheelFun
 /// to disable the sensor.
 ///
 /// Sensors are automatically disabled when the app is inactive, and re-enabled when active again.
+///
+/// - Emscripten: On browsers that require permission to read motion sensors (Safari on iOS), permission is requested
+///   on the next tap, and sensor events begin after the user grants it.
 GLFMSensorFunc glfmSetSensorFunc(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorFunc sensorFunc);
 
+/// Sets the function to call with every sample of a particular hardware sensor.
+///
+/// The ``GLFMSensorFunc`` only receives the latest sample when several samples arrive at once. The
+/// ``GLFMSensorBatchFunc`` receives all of them, with their timestamps, which is useful for motion tracking at high
+/// sample rates. Both functions may be set for the same sensor.
+///
+/// The hardware sensor is enabled when either the `sensorFunc` or the `batchFunc` is not `NULL`.
+///
+/// - iOS: Samples are read once per frame, so each batch contains one sample.
+///
+/// - Emscripten: Samples are queued as the browser delivers them, and sent once per frame.
+GLFMSensorBatchFunc glfmSetSensorBatchFunc(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorBatchFunc batchFunc);
+
+/// Sets the sampling rate of a hardware sensor, in Hz, and the maximum time, in seconds, that samples may be batched in
+/// the hardware FIFO before they are delivered.
+///
+/// A `hz` of `0` uses the default rate (100 Hz). The rate is limited to the fastest rate the sensor supports, so a
+/// large value (like `1000`) requests the maximum rate.
+///
+/// A `maxLatency` of `0` delivers samples as soon as possible. A larger latency lets the device sleep while the sensor
+/// hardware collects samples. Use it with ``glfmSetSensorBatchFunc`` to receive all of them.
+///
+/// The rate is a hint; the system may deliver samples faster or slower. This function may be called before or after
+/// the sensor is enabled.
+///
+/// - Android: `maxLatency` requires Android 8.0 (API 26) or newer, and is ignored on older versions.
+///
+/// - iOS: All sensors share one update interval, which is the fastest rate requested. `maxLatency` is ignored.
+///
+/// - Emscripten: Not supported.
+void glfmSetSensorRate(GLFMDisplay *display, GLFMSensor sensor, double hz, double maxLatency);
+
+/// Gets a sample of a hardware sensor at an arbitrary time, like the time the next frame is expected to be displayed.
+///
+/// The sample is interpolated from the recent samples of the sensor. Vectors are interpolated linearly, and rotation
+/// matrices are interpolated with spherical linear interpolation (slerp). Times after the newest sample are
+/// extrapolated from the two newest samples, up to 0.1 seconds ahead. Times before the oldest sample return the
+/// oldest sample.
+///
+/// The `time` is in the same timebase as ``glfmGetTime``. The `timestamp` of the returned event is in the timebase of
+/// `GLFMSensorEvent` timestamps.
+///
+/// The sensor must be enabled (see ``glfmSetSensorFunc``). Samples read from a direct channel are not included.
+///
+/// Returns `false` if no samples have been received.
+bool glfmGetSensorSampleAt(const GLFMDisplay *display, GLFMSensor sensor, double time, GLFMSensorEvent *event);
+
+/// Sets how the ``GLFMSensorRotationMatrix`` sensor is computed. The default is
+/// ``GLFMSensorFusionModeAutomatic``.
+///
+/// Sensor fusion combines the gyroscope, which is smooth but drifts over time, with the accelerometer and
+/// magnetometer, which are noisy but stable, using a Mahony filter. If the device has no magnetometer, the X axis of
+/// the rotation matrix points in an arbitrary horizontal direction instead of North.
+///
+/// - Android: Devices without a rotation vector sensor use sensor fusion in ``GLFMSensorFusionModeAutomatic``.
+///
+/// - iOS, Emscripten: The platform's rotation is always used.
+void glfmSetSensorFusionMode(GLFMDisplay *display, GLFMSensorFusionMode mode);
+
+/// Gets how the rotation sensor is computed. See ``glfmSetSensorFusionMode``.
+GLFMSensorFusionMode glfmGetSensorFusionMode(const GLFMDisplay *display);
+
+/// Gets the latest device rotation as a unit quaternion (`x`, `y`, `z`, `w`).
+///
+/// The quaternion is the same rotation as the ``GLFMSensorRotationMatrix`` matrix, but when sensor fusion is used it
+/// is read directly from the filter without converting to and from a matrix.
+///
+/// The ``GLFMSensorRotationMatrix`` sensor must be enabled (see ``glfmSetSensorFunc``). Returns `false` if no rotation
+/// is available yet.
+bool glfmGetSensorRotationQuaternion(const GLFMDisplay *display, double quaternion[4]);
+
+/// Returns true if the hardware sensor can stream samples to a shared-memory direct channel.
+/// See ``glfmSetSensorDirectChannelEnabled``.
+bool glfmIsSensorDirectChannelAvailable(const GLFMDisplay *display, GLFMSensor sensor);
+
+/// Enables or disables streaming a hardware sensor into a shared-memory ring buffer at the fastest rate the hardware
+/// supports.
+///
+/// A direct channel bypasses the event queue, ``GLFMSensorFunc``, and ``GLFMSensorBatchFunc``: the sensor hardware
+/// writes samples straight to memory, and the app reads them with ``glfmReadSensorDirectChannel``. This keeps CPU usage
+/// low at high rates (hundreds of samples per second). The channel is paused while the app is inactive.
+///
+/// Only ``GLFMSensorAccelerometer``, ``GLFMSensorMagnetometer``, and ``GLFMSensorGyroscope`` are supported.
+///
+/// Returns `true` if the direct channel is enabled after the call.
+///
+/// - Android: Requires Android 8.0 (API 26) or newer, and a sensor that supports direct channels.
+///
+/// - iOS, Emscripten: Not supported.
+bool glfmSetSensorDirectChannelEnabled(GLFMDisplay *display, GLFMSensor sensor, bool enabled);
+
+/// Reads new samples from a sensor's direct channel, oldest first, without locking or blocking.
+///
+/// Returns the number of events written to `events`, up to `maxEvents`. Samples not read before the ring buffer wraps
+/// are lost, so call this function often (for example, once per frame). Only call it from one thread.
+int glfmReadSensorDirectChannel(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorEvent *events, int maxEvents);
+
+// MARK: - Resources
+
+/// Adds a resource that GLFM creates, and re-creates whenever the surface is re-created (for example, after the OpenGL
+/// context is lost).
+///
+/// Instead of re-creating every resource in ``GLFMSurfaceCreatedFunc``, which can stall for a long time, GLFM calls the
+/// `createFunc` of pending resources right before ``GLFMRenderFunc``, a few milliseconds' worth per frame, in the
+/// order they were added. Use ``glfmIsResourceReady`` to check if a resource can be drawn.
+///
+/// The `createFunc` is first called before the next ``GLFMRenderFunc``, not during this call. When the surface is
+/// destroyed, the app should forget its OpenGL names for the resource without deleting them.
+///
+/// The `data` is copied, and kept in memory until the resource is removed. It may be `NULL` if the `createFunc` can
+/// create the resource from `userData`.
+///
+/// Returns a resource ID greater than `0`, or `0` on failure.
+int glfmAddResource(GLFMDisplay *display, GLFMResourceCreateFunc createFunc, const void *data, size_t size,
+                    void *userData);
+
+/// Removes a resource added with ``glfmAddResource`` and frees its copy of the data. The app should delete the OpenGL
+/// resource itself.
+///
+/// A resource must not be removed from its own `GLFMResourceCreateFunc`.
+void glfmRemoveResource(GLFMDisplay *display, int resourceID);
+
+/// Returns `true` if the resource was created since the surface was last created.
+bool glfmIsResourceReady(const GLFMDisplay *display, int resourceID);
+
+/// Returns `true` if any resource added with ``glfmAddResource`` hasn't been created yet.
+bool glfmHasPendingResources(const GLFMDisplay *display);
+
 // MARK: - Haptics
 
 /// Returns true if the device supports haptic feedback.
@@ -5,6 +5,7 @@
 
 #include "glfm.h"
 #include "glfm_internal.h"
+#include "glfm_sensor_fusion.h"
 
 #include <EGL/egl.h>
 #include <android/configuration.h>
@@ -13,6 +14,7 @@
 #include <assert.h>
 #include <dlfcn.h>
 #include <pthread.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #define GLFM_LOG_LIFECYCLE_ENABLE 0
@@ -33,12 +35,52 @@
 #define GLFM_MAX_SIMULTANEOUS_TOUCHES 5
 // Same update interval as iOS
 #define GLFM_SENSOR_UPDATE_INTERVAL_MICROS ((int)(0.01 * 1000000))
+#define GLFM_SENSOR_EVENT_BATCH_SIZE 32
+#define GLFM_SENSOR_DIRECT_CHANNEL_EVENT_COUNT 1024
 #define GLFM_RESIZE_EVENT_MAX_WAIT_FRAMES 5
+#define GLFM_MAX_DAMAGE_RECTS 16
 
 // If GLFM_HANDLE_BACK_BUTTON is 1, when the user presses the back button, the task is moved to the back. Otherwise,
 // when the user presses the back button, the activity is destroyed.
 #define GLFM_HANDLE_BACK_BUTTON 1
 
+// MARK: - EGL extensions
+
+// From eglext.h. Not all NDK versions declare these.
+typedef EGLBoolean (EGLAPIENTRYP GLFMEGLSwapBuffersWithDamageProc)(EGLDisplay display, EGLSurface surface,
+                                                                  const EGLint *rects, EGLint numRects);
+typedef EGLBoolean (EGLAPIENTRYP GLFMEGLSetDamageRegionProc)(EGLDisplay display, EGLSurface surface,
+                                                             EGLint *rects, EGLint numRects);
+
+// Same signature for glInvalidateFramebuffer (OpenGL ES 3) and glDiscardFramebufferEXT (OpenGL ES 2)
+typedef void (GL_APIENTRYP GLFMInvalidateFramebufferProc)(GLenum target, GLsizei numAttachments,
+                                                          const GLenum *attachments);
+
+// Available in native_window.h in API 26
+typedef int32_t (*GLFMANativeWindowSetBuffersTransformProc)(ANativeWindow *window, int32_t transform);
+
+// Available in sensor.h in API 26
+typedef int (*GLFMASensorEventQueueRegisterSensorProc)(ASensorEventQueue *queue, const ASensor *sensor,
+                                                       int32_t samplingPeriodUs, int64_t maxBatchReportLatencyUs);
+typedef bool (*GLFMASensorIsDirectChannelTypeSupportedProc)(const ASensor *sensor, int channelType);
+typedef int (*GLFMASensorGetHighestDirectReportRateLevelProc)(const ASensor *sensor);
+typedef int (*GLFMASensorManagerCreateSharedMemoryDirectChannelProc)(ASensorManager *manager, int fd, size_t size);
+typedef void (*GLFMASensorManagerDestroyDirectChannelProc)(ASensorManager *manager, int channelId);
+typedef int (*GLFMASensorManagerConfigureDirectReportProc)(ASensorManager *manager, const ASensor *sensor,
+                                                           int channelId, int rate);
+
+// Available in sharedmem.h in API 26
+typedef int (*GLFMASharedMemoryCreateProc)(const char *name, size_t size);
+
+typedef struct {
+    int channelId;
+    int fd;
+    const ASensorEvent *events;
+    uint32_t lastCounter;
+    int readIndex;
+    bool active;
+} GLFMSensorDirectChannel;
+
 // MARK: - Platform data (global singleton)
 
 typedef struct {
@@ -74,6 +116,7 @@ typedef struct {
     bool animating;
     bool refreshRequested;
     bool swapCalled;
+    bool rendering;
     bool surfaceCreatedNotified;
     double lastSwapTime;
 
@@ -83,9 +126,23 @@ typedef struct {
     EGLContext eglContext;
     bool eglContextCurrent;
 
+    struct {
+        bool bufferAge;
+        GLFMEGLSwapBuffersWithDamageProc swapBuffersWithDamage;
+        GLFMEGLSetDamageRegionProc setDamageRegion;
+    } eglExtensions;
+
+    bool invalidateFramebufferChecked;
+    GLFMInvalidateFramebufferProc invalidateFramebuffer;
+
     int32_t width;
     int32_t height;
     double scale;
+    double renderScale;
+    float refreshRate;
+    GLFMSurfaceTransform preTransform;
+    bool setBuffersTransformChecked;
+    GLFMANativeWindowSetBuffersTransformProc setBuffersTransform;
     int resizeEventWaitFrames;
 
     struct {
@@ -98,8 +155,28 @@ typedef struct {
 
     ASensorEventQueue *sensorEventQueue;
     GLFMSensorEvent sensorEvent[GLFM_NUM_SENSORS];
+    GLFMSensorEvent sensorEventBatch[GLFM_NUM_SENSORS][GLFM_SENSOR_EVENT_BATCH_SIZE];
+    int sensorEventBatchCount[GLFM_NUM_SENSORS];
     bool sensorEventValid[GLFM_NUM_SENSORS];
     bool deviceSensorEnabled[GLFM_NUM_SENSORS];
+    int32_t deviceSensorPeriodMicros[GLFM_NUM_SENSORS];
+    int64_t deviceSensorLatencyMicros[GLFM_NUM_SENSORS];
+    bool registerSensorChecked;
+    GLFMASensorEventQueueRegisterSensorProc registerSensor;
+
+    GLFMSensorFusion sensorFusion;
+    bool sensorFusionInUse;
+
+    GLFMSensorDirectChannel sensorDirectChannels[GLFM_NUM_SENSORS];
+    bool sensorDirectChannelFuncsChecked;
+    struct {
+        GLFMASensorIsDirectChannelTypeSupportedProc isDirectChannelTypeSupported;
+        GLFMASensorGetHighestDirectReportRateLevelProc getHighestDirectReportRateLevel;
+        GLFMASensorManagerCreateSharedMemoryDirectChannelProc createSharedMemoryDirectChannel;
+        GLFMASensorManagerDestroyDirectChannelProc destroyDirectChannel;
+        GLFMASensorManagerConfigureDirectReportProc configureDirectReport;
+        GLFMASharedMemoryCreateProc sharedMemoryCreate;
+    } sensorDirectChannelFuncs;
 
     GLFMInterfaceOrientation orientation;
 
@@ -113,12 +190,15 @@ static GLFMPlatformData *platformDataGlobal = NULL;
 static void *glfm__mainLoop(void *param);
 static int glfm__looperCallback(int pipe, int events, void *userData);
 static void glfm__setAllRequestedSensorsEnabled(GLFMDisplay *display, bool enable);
+static void glfm__destroyAllSensorDirectChannels(GLFMPlatformData *platformData);
 static void glfm__reportOrientationChangeIfNeeded(GLFMDisplay *display);
 static void glfm__reportInsetsChangedIfNeeded(GLFMDisplay *display);
 static bool glfm__updateSurfaceSizeIfNeeded(GLFMDisplay *display, bool force);
 static float glfm__getRefreshRate(const GLFMDisplay *display);
 static void glfm__getDisplayChromeInsets(const GLFMDisplay *display, int *top, int *right, int *bottom, int *left);
 static void glfm__resetContentRect(GLFMPlatformData *platformData);
+static void glfm__onInputEvent(GLFMPlatformData *platformData);
+static void glfm__onSensorEvent(GLFMPlatformData *platformData);
 static void glfm__updateKeyboardVisibility(GLFMPlatformData *platformData);
 static void glfm__updateUserInterfaceChrome(GLFMPlatformData *platformData);
 
@@ -290,6 +370,10 @@ static bool glfm__eglContextInit(GLFMPlatformData *platformData) {
 
     GLFM_LOG_LIFECYCLE("GL Context made current");
     platformData->eglContextCurrent = true;
+    if (created) {
+        platformData->invalidateFramebufferChecked = false;
+        glfm__clearSupportedExtensions(platformData->display);
+    }
     if (created && !platformData->surfaceCreatedNotified) {
         platformData->surfaceCreatedNotified = true;
         if (platformData->display && platformData->display->surfaceCreatedFunc) {
@@ -355,8 +439,129 @@ static void glfm__eglLogConfig(GLFMPlatformData *platformData, EGLConfig config)
 
 #endif
 
+static GLFMSurfaceTransform glfm__getSurfaceTransformHint(const GLFMPlatformData *platformData) {
+    // The orientation is relative to the natural orientation of the display
+    switch (platformData->orientation) {
+        case GLFMInterfaceOrientationLandscapeRight:
+            return GLFMSurfaceTransformRotate90;
+        case GLFMInterfaceOrientationPortraitUpsideDown:
+            return GLFMSurfaceTransformRotate180;
+        case GLFMInterfaceOrientationLandscapeLeft:
+            return GLFMSurfaceTransformRotate270;
+        case GLFMInterfaceOrientationPortrait:
+        case GLFMInterfaceOrientationUnknown:
+        default:
+            return GLFMSurfaceTransformIdentity;
+    }
+}
+
+static GLFMANativeWindowSetBuffersTransformProc glfm__getSetBuffersTransformFunc(GLFMPlatformData *platformData) {
+    if (!platformData->setBuffersTransformChecked) {
+        platformData->setBuffersTransformChecked = true;
+        platformData->setBuffersTransform = NULL;
+        if (platformData->activity && platformData->activity->sdkVersion >= 26) {
+            platformData->setBuffersTransform =
+                (GLFMANativeWindowSetBuffersTransformProc)dlsym(RTLD_DEFAULT, "ANativeWindow_setBuffersTransform");
+        }
+    }
+    return platformData->setBuffersTransform;
+}
+
+static GLFMSurfaceTransform glfm__getRequestedPreTransform(GLFMPlatformData *platformData) {
+    if (platformData->display && platformData->display->preRotationEnabled &&
+        glfm__getSetBuffersTransformFunc(platformData)) {
+        return glfm__getSurfaceTransformHint(platformData);
+    }
+    return GLFMSurfaceTransformIdentity;
+}
+
+static bool glfm__isPreTransformRotated(GLFMSurfaceTransform transform) {
+    return transform == GLFMSurfaceTransformRotate90 || transform == GLFMSurfaceTransformRotate270;
+}
+
+static void glfm__updateBuffersGeometry(GLFMPlatformData *platformData) {
+    // From native_window.h
+    static const int32_t ANATIVEWINDOW_TRANSFORM_IDENTITY = 0x00;
+    static const int32_t ANATIVEWINDOW_TRANSFORM_ROTATE_90 = 0x04;
+    static const int32_t ANATIVEWINDOW_TRANSFORM_ROTATE_180 = 0x03;
+    static const int32_t ANATIVEWINDOW_TRANSFORM_ROTATE_270 = 0x07;
+
+    if (!platformData->window || platformData->eglDisplay == EGL_NO_DISPLAY) {
+        return;
+    }
+    EGLint format = 0;
+    eglGetConfigAttrib(platformData->eglDisplay, platformData->eglConfig, EGL_NATIVE_VISUAL_ID, &format);
+
+    // Reset to the window size, then shrink (or rotate) the buffers. The compositor scales them up to fill the window.
+    const double renderScale = glfm__getRenderScale(platformData->display);
+    const GLFMSurfaceTransform preTransform = glfm__getRequestedPreTransform(platformData);
+    const bool rotated = glfm__isPreTransformRotated(preTransform);
+    ANativeWindow_setBuffersGeometry(platformData->window, 0, 0, format);
+    if (renderScale < 1.0 || rotated) {
+        const int32_t windowWidth = ANativeWindow_getWidth(platformData->window);
+        const int32_t windowHeight = ANativeWindow_getHeight(platformData->window);
+        if (windowWidth > 0 && windowHeight > 0) {
+            int32_t width = (int32_t)(windowWidth * renderScale + 0.5);
+            int32_t height = (int32_t)(windowHeight * renderScale + 0.5);
+            width = width > 0 ? width : 1;
+            height = height > 0 ? height : 1;
+            ANativeWindow_setBuffersGeometry(platformData->window, rotated ? height : width,
+                                             rotated ? width : height, format);
+        }
+    }
+
+    GLFMANativeWindowSetBuffersTransformProc setBuffersTransform = glfm__getSetBuffersTransformFunc(platformData);
+    if (setBuffersTransform) {
+        int32_t transform;
+        switch (preTransform) {
+            case GLFMSurfaceTransformIdentity: default:
+                transform = ANATIVEWINDOW_TRANSFORM_IDENTITY;
+                break;
+            case GLFMSurfaceTransformRotate90:
+                transform = ANATIVEWINDOW_TRANSFORM_ROTATE_90;
+                break;
+            case GLFMSurfaceTransformRotate180:
+                transform = ANATIVEWINDOW_TRANSFORM_ROTATE_180;
+                break;
+            case GLFMSurfaceTransformRotate270:
+                transform = ANATIVEWINDOW_TRANSFORM_ROTATE_270;
+                break;
+        }
+        setBuffersTransform(platformData->window, transform);
+    }
+    if (preTransform != platformData->preTransform) {
+        platformData->resizeEventWaitFrames = 0;
+    }
+    platformData->preTransform = preTransform;
+    if (renderScale < platformData->renderScale || renderScale > platformData->renderScale) {
+        // Report the new surface size as soon as it's available, without waiting for a content rect change.
+        platformData->resizeEventWaitFrames = 0;
+    }
+    platformData->renderScale = renderScale;
+}
+
+static void glfm__eglExtensionsInit(GLFMPlatformData *platformData) {
+    const char *extensions = eglQueryString(platformData->eglDisplay, EGL_EXTENSIONS);
+    platformData->eglExtensions.bufferAge = (glfm__hasExtension(extensions, "EGL_EXT_buffer_age") ||
+                                             glfm__hasExtension(extensions, "EGL_KHR_partial_update"));
+    platformData->eglExtensions.swapBuffersWithDamage = NULL;
+    if (glfm__hasExtension(extensions, "EGL_KHR_swap_buffers_with_damage")) {
+        platformData->eglExtensions.swapBuffersWithDamage =
+            (GLFMEGLSwapBuffersWithDamageProc)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+    } else if (glfm__hasExtension(extensions, "EGL_EXT_swap_buffers_with_damage")) {
+        platformData->eglExtensions.swapBuffersWithDamage =
+            (GLFMEGLSwapBuffersWithDamageProc)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+    }
+    platformData->eglExtensions.setDamageRegion = NULL;
+    if (glfm__hasExtension(extensions, "EGL_KHR_partial_update")) {
+        platformData->eglExtensions.setDamageRegion =
+            (GLFMEGLSetDamageRegionProc)eglGetProcAddress("eglSetDamageRegionKHR");
+    }
+}
+
 static bool glfm__eglInit(GLFMPlatformData *platformData) {
     if (platformData->eglDisplay != EGL_NO_DISPLAY) {
+        glfm__updateBuffersGeometry(platformData);
         glfm__eglSurfaceInit(platformData);
         return glfm__eglContextInit(platformData);
     }
@@ -410,11 +615,11 @@ static bool glfm__eglInit(GLFMPlatformData *platformData) {
 
     EGLint majorVersion = 0;
     EGLint minorVersion = 0;
-    EGLint format = 0;
     EGLint numConfigs = 0;
 
     platformData->eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
     eglInitialize(platformData->eglDisplay, &majorVersion, &minorVersion);
+    glfm__eglExtensionsInit(platformData);
 
     while (true) {
         const EGLint attribList[] = {
@@ -471,16 +676,19 @@ static bool glfm__eglInit(GLFMPlatformData *platformData) {
         }
     }
 
+    glfm__updateBuffersGeometry(platformData);
     glfm__eglSurfaceInit(platformData);
 
     eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_WIDTH,
                     &platformData->width);
     eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_HEIGHT,
                     &platformData->height);
-    eglGetConfigAttrib(platformData->eglDisplay, platformData->eglConfig, EGL_NATIVE_VISUAL_ID,
-                       &format);
-
-    ANativeWindow_setBuffersGeometry(platformData->window, 0, 0, format);
+    if (glfm__isPreTransformRotated(platformData->preTransform)) {
+        // Report the logical size
+        int32_t width = platformData->width;
+        platformData->width = platformData->height;
+        platformData->height = width;
+    }
 
     return glfm__eglContextInit(platformData);
 }
@@ -501,6 +709,7 @@ static void glfm__eglDestroy(GLFMPlatformData *platformData) {
             GLFM_LOG_LIFECYCLE("GL Context destroyed");
             if (platformData->surfaceCreatedNotified) {
                 platformData->surfaceCreatedNotified = false;
+                glfm__invalidateResources(platformData->display);
                 if (platformData->display && platformData->display->surfaceDestroyedFunc) {
                     platformData->display->surfaceDestroyedFunc(platformData->display);
                 }
@@ -517,6 +726,26 @@ static void glfm__eglDestroy(GLFMPlatformData *platformData) {
     platformData->eglContextCurrent = false;
 }
 
+static bool glfm__eglSurfaceRecreate(GLFMPlatformData *platformData) {
+    if (platformData->eglDisplay == EGL_NO_DISPLAY || platformData->eglContext == EGL_NO_CONTEXT ||
+        !platformData->window) {
+        return false;
+    }
+    glfm__eglSurfaceDestroy(platformData);
+    glfm__eglSurfaceInit(platformData);
+    return glfm__eglContextInit(platformData);
+}
+
+static void glfm__eglRelease(GLFMPlatformData *platformData) {
+    if (platformData->display && platformData->display->contextPreservationEnabled) {
+        // Keep the EGLDisplay and EGLContext. The next call to glfm__eglInit() reuses them.
+        GLFM_LOG_LIFECYCLE("GL Context preserved");
+        glfm__eglSurfaceDestroy(platformData);
+    } else {
+        glfm__eglDestroy(platformData);
+    }
+}
+
 static void glfm__eglCheckError(GLFMPlatformData *platformData) {
     EGLint err = eglGetError();
     if (err == EGL_BAD_SURFACE) {
@@ -529,6 +758,7 @@ static void glfm__eglCheckError(GLFMPlatformData *platformData) {
             GLFM_LOG_LIFECYCLE("GL Context lost");
             if (platformData->surfaceCreatedNotified) {
                 platformData->surfaceCreatedNotified = false;
+                glfm__invalidateResources(platformData->display);
                 if (platformData->display && platformData->display->surfaceDestroyedFunc) {
                     platformData->display->surfaceDestroyedFunc(platformData->display);
                 }
@@ -536,6 +766,13 @@ static void glfm__eglCheckError(GLFMPlatformData *platformData) {
         }
         glfm__eglContextInit(platformData);
     } else {
+        if (platformData->display && platformData->display->contextPreservationEnabled) {
+            // Try to recover without losing the context. A real context loss is reported above.
+            GLFM_LOG_LIFECYCLE("EGL error 0x%04x; recreating surface", err);
+            if (glfm__eglSurfaceRecreate(platformData)) {
+                return;
+            }
+        }
         glfm__eglDestroy(platformData);
         glfm__eglInit(platformData);
     }
@@ -547,6 +784,13 @@ static void glfm__drawFrame(GLFMPlatformData *platformData) {
         return;
     }
 
+    // Apply render scale and pre-rotation changes. The new surface size is reported after the next swap.
+    const double renderScale = glfm__getRenderScale(platformData->display);
+    if (renderScale < platformData->renderScale || renderScale > platformData->renderScale ||
+        glfm__getRequestedPreTransform(platformData) != platformData->preTransform) {
+        glfm__updateBuffersGeometry(platformData);
+    }
+
     // Check for resize (or rotate)
     glfm__updateSurfaceSizeIfNeeded(platformData->display, false);
 
@@ -557,9 +801,14 @@ static void glfm__drawFrame(GLFMPlatformData *platformData) {
             platformData->display->surfaceRefreshFunc(platformData->display);
         }
     }
+    glfm__flushCoalescedTouches(platformData->display);
+    glfm__createPendingResources(platformData->display);
     if (platformData->display && platformData->display->renderFunc) {
+        platformData->rendering = true;
         platformData->display->renderFunc(platformData->display);
+        platformData->rendering = false;
     }
+    glfm__clearEndedTouches(platformData->display);
 }
 
 // MARK: - ANativeActivity callbacks (UI thread)
@@ -837,6 +1086,9 @@ static void glfm__setAnimating(GLFMPlatformData *platformData, bool animating) {
     if (platformData->animating != animating) {
         platformData->animating = animating;
         platformData->refreshRequested = true;
+        if (!animating) {
+            glfm__clearKeysDown(platformData->display);
+        }
         if (platformData->display && platformData->display->focusFunc) {
             platformData->display->focusFunc(platformData->display, animating);
         }
@@ -853,6 +1105,7 @@ static void glfm__onAppCmd(GLFMPlatformData *platformData, GLFMActivityCommand c
             pthread_cond_broadcast(&platformData->cond);
             pthread_mutex_unlock(&platformData->mutex);
 
+            platformData->refreshRate = glfm__getRefreshRate(platformData->display);
             const bool success = glfm__eglInit(platformData);
             if (!success) {
                 glfm__eglCheckError(platformData);
@@ -863,6 +1116,10 @@ static void glfm__onAppCmd(GLFMPlatformData *platformData, GLFMActivityCommand c
         }
         case GLFMActivityCommandOnNativeWindowResized: {
             GLFM_LOG_LIFECYCLE("OnNativeWindowResized");
+            if (platformData->renderScale < 1.0 || platformData->preTransform != GLFMSurfaceTransformIdentity) {
+                // Buffers with a fixed size don't follow the window size
+                glfm__updateBuffersGeometry(platformData);
+            }
             break;
         }
         case GLFMActivityCommandOnNativeWindowDestroyed: {
@@ -902,6 +1159,7 @@ static void glfm__onAppCmd(GLFMPlatformData *platformData, GLFMActivityCommand c
 #endif
 
             platformData->refreshRequested = true;
+            platformData->refreshRate = glfm__getRefreshRate(platformData->display);
             if (platformData->window) {
                 bool sizedChanged = glfm__updateSurfaceSizeIfNeeded(platformData->display, true);
                 if (!sizedChanged) {
@@ -945,7 +1203,7 @@ static void glfm__onAppCmd(GLFMPlatformData *platformData, GLFMActivityCommand c
 #endif
         case GLFMActivityCommandOnDestroy: {
             GLFM_LOG_LIFECYCLE("OnDestroy");
-            glfm__eglDestroy(platformData);
+            glfm__eglRelease(platformData);
             glfm__setAnimating(platformData, false);
             platformData->destroyRequested = true;
             break;
@@ -1096,168 +1354,162 @@ static bool glfm__onKeyEvent(GLFMPlatformData *platformData, AInputEvent *event)
         return true;
     }
     bool handled = false;
-    if (display->keyFunc) {
-        static const GLFMKeyCode AKEYCODE_MAP[] = {
-                [AKEYCODE_BACK]            = GLFMKeyCodeNavigationBack,
-
-                [AKEYCODE_0]               = GLFMKeyCode0,
-                [AKEYCODE_1]               = GLFMKeyCode1,
-                [AKEYCODE_2]               = GLFMKeyCode2,
-                [AKEYCODE_3]               = GLFMKeyCode3,
-                [AKEYCODE_4]               = GLFMKeyCode4,
-                [AKEYCODE_5]               = GLFMKeyCode5,
-                [AKEYCODE_6]               = GLFMKeyCode6,
-                [AKEYCODE_7]               = GLFMKeyCode7,
-                [AKEYCODE_8]               = GLFMKeyCode8,
-                [AKEYCODE_9]               = GLFMKeyCode9,
-
-                [AKEYCODE_DPAD_UP]         = GLFMKeyCodeArrowUp,
-                [AKEYCODE_DPAD_DOWN]       = GLFMKeyCodeArrowDown,
-                [AKEYCODE_DPAD_LEFT]       = GLFMKeyCodeArrowLeft,
-                [AKEYCODE_DPAD_RIGHT]      = GLFMKeyCodeArrowRight,
-
-                [AKEYCODE_POWER]           = GLFMKeyCodePower,
-
-                [AKEYCODE_A]               = GLFMKeyCodeA,
-                [AKEYCODE_B]               = GLFMKeyCodeB,
-                [AKEYCODE_C]               = GLFMKeyCodeC,
-                [AKEYCODE_D]               = GLFMKeyCodeD,
-                [AKEYCODE_E]               = GLFMKeyCodeE,
-                [AKEYCODE_F]               = GLFMKeyCodeF,
-                [AKEYCODE_G]               = GLFMKeyCodeG,
-                [AKEYCODE_H]               = GLFMKeyCodeH,
-                [AKEYCODE_I]               = GLFMKeyCodeI,
-                [AKEYCODE_J]               = GLFMKeyCodeJ,
-                [AKEYCODE_K]               = GLFMKeyCodeK,
-                [AKEYCODE_L]               = GLFMKeyCodeL,
-                [AKEYCODE_M]               = GLFMKeyCodeM,
-                [AKEYCODE_N]               = GLFMKeyCodeN,
-                [AKEYCODE_O]               = GLFMKeyCodeO,
-                [AKEYCODE_P]               = GLFMKeyCodeP,
-                [AKEYCODE_Q]               = GLFMKeyCodeQ,
-                [AKEYCODE_R]               = GLFMKeyCodeR,
-                [AKEYCODE_S]               = GLFMKeyCodeS,
-                [AKEYCODE_T]               = GLFMKeyCodeT,
-                [AKEYCODE_U]               = GLFMKeyCodeU,
-                [AKEYCODE_V]               = GLFMKeyCodeV,
-                [AKEYCODE_W]               = GLFMKeyCodeW,
-                [AKEYCODE_X]               = GLFMKeyCodeX,
-                [AKEYCODE_Y]               = GLFMKeyCodeY,
-                [AKEYCODE_Z]               = GLFMKeyCodeZ,
-                [AKEYCODE_COMMA]           = GLFMKeyCodeComma,
-                [AKEYCODE_PERIOD]          = GLFMKeyCodePeriod,
-                [AKEYCODE_ALT_LEFT]        = GLFMKeyCodeAltLeft,
-                [AKEYCODE_ALT_RIGHT]       = GLFMKeyCodeAltRight,
-                [AKEYCODE_SHIFT_LEFT]      = GLFMKeyCodeShiftLeft,
-                [AKEYCODE_SHIFT_RIGHT]     = GLFMKeyCodeShiftRight,
-                [AKEYCODE_TAB]             = GLFMKeyCodeTab,
-                [AKEYCODE_SPACE]           = GLFMKeyCodeSpace,
-
-                [AKEYCODE_ENTER]           = GLFMKeyCodeEnter,
-                [AKEYCODE_DEL]             = GLFMKeyCodeBackspace,
-                [AKEYCODE_GRAVE]           = GLFMKeyCodeBackquote,
-                [AKEYCODE_MINUS]           = GLFMKeyCodeMinus,
-                [AKEYCODE_EQUALS]          = GLFMKeyCodeEqual,
-                [AKEYCODE_LEFT_BRACKET]    = GLFMKeyCodeBracketLeft,
-                [AKEYCODE_RIGHT_BRACKET]   = GLFMKeyCodeBracketRight,
-                [AKEYCODE_BACKSLASH]       = GLFMKeyCodeBackslash,
-                [AKEYCODE_SEMICOLON]       = GLFMKeyCodeSemicolon,
-                [AKEYCODE_APOSTROPHE]      = GLFMKeyCodeQuote,
-                [AKEYCODE_SLASH]           = GLFMKeyCodeSlash,
-
-                [AKEYCODE_MENU]            = GLFMKeyCodeMenu,
-
-                [AKEYCODE_PAGE_UP]         = GLFMKeyCodePageUp,
-                [AKEYCODE_PAGE_DOWN]       = GLFMKeyCodePageDown,
-
-                [AKEYCODE_ESCAPE]          = GLFMKeyCodeEscape,
-                [AKEYCODE_FORWARD_DEL]     = GLFMKeyCodeDelete,
-                [AKEYCODE_CTRL_LEFT]       = GLFMKeyCodeControlLeft,
-                [AKEYCODE_CTRL_RIGHT]      = GLFMKeyCodeControlRight,
-                [AKEYCODE_CAPS_LOCK]       = GLFMKeyCodeCapsLock,
-                [AKEYCODE_SCROLL_LOCK]     = GLFMKeyCodeScrollLock,
-                [AKEYCODE_META_LEFT]       = GLFMKeyCodeMetaLeft,
-                [AKEYCODE_META_RIGHT]      = GLFMKeyCodeMetaRight,
-                [AKEYCODE_FUNCTION]        = GLFMKeyCodeFunction,
-                [AKEYCODE_SYSRQ]           = GLFMKeyCodePrintScreen,
-                [AKEYCODE_BREAK]           = GLFMKeyCodePause,
-                [AKEYCODE_MOVE_HOME]       = GLFMKeyCodeHome,
-                [AKEYCODE_MOVE_END]        = GLFMKeyCodeEnd,
-                [AKEYCODE_INSERT]          = GLFMKeyCodeInsert,
-
-                [AKEYCODE_F1]              = GLFMKeyCodeF1,
-                [AKEYCODE_F2]              = GLFMKeyCodeF2,
-                [AKEYCODE_F3]              = GLFMKeyCodeF3,
-                [AKEYCODE_F4]              = GLFMKeyCodeF4,
-                [AKEYCODE_F5]              = GLFMKeyCodeF5,
-                [AKEYCODE_F6]              = GLFMKeyCodeF6,
-                [AKEYCODE_F7]              = GLFMKeyCodeF7,
-                [AKEYCODE_F8]              = GLFMKeyCodeF8,
-                [AKEYCODE_F9]              = GLFMKeyCodeF9,
-                [AKEYCODE_F10]             = GLFMKeyCodeF10,
-                [AKEYCODE_F11]             = GLFMKeyCodeF11,
-                [AKEYCODE_F12]             = GLFMKeyCodeF12,
-                [AKEYCODE_NUM_LOCK]        = GLFMKeyCodeNumLock,
-                [AKEYCODE_NUMPAD_0]        = GLFMKeyCodeNumpad0,
-                [AKEYCODE_NUMPAD_1]        = GLFMKeyCodeNumpad1,
-                [AKEYCODE_NUMPAD_2]        = GLFMKeyCodeNumpad2,
-                [AKEYCODE_NUMPAD_3]        = GLFMKeyCodeNumpad3,
-                [AKEYCODE_NUMPAD_4]        = GLFMKeyCodeNumpad4,
-                [AKEYCODE_NUMPAD_5]        = GLFMKeyCodeNumpad5,
-                [AKEYCODE_NUMPAD_6]        = GLFMKeyCodeNumpad6,
-                [AKEYCODE_NUMPAD_7]        = GLFMKeyCodeNumpad7,
-                [AKEYCODE_NUMPAD_8]        = GLFMKeyCodeNumpad8,
-                [AKEYCODE_NUMPAD_9]        = GLFMKeyCodeNumpad9,
-                [AKEYCODE_NUMPAD_DIVIDE]   = GLFMKeyCodeNumpadDivide,
-                [AKEYCODE_NUMPAD_MULTIPLY] = GLFMKeyCodeNumpadMultiply,
-                [AKEYCODE_NUMPAD_SUBTRACT] = GLFMKeyCodeNumpadSubtract,
-                [AKEYCODE_NUMPAD_ADD]      = GLFMKeyCodeNumpadAdd,
-                [AKEYCODE_NUMPAD_DOT]      = GLFMKeyCodeNumpadDecimal,
-                [AKEYCODE_NUMPAD_ENTER]    = GLFMKeyCodeNumpadEnter,
-                [AKEYCODE_NUMPAD_EQUALS]   = GLFMKeyCodeNumpadEqual,
-        };
+    static const GLFMKeyCode AKEYCODE_MAP[] = {
+            [AKEYCODE_BACK]            = GLFMKeyCodeNavigationBack,
+
+            [AKEYCODE_0]               = GLFMKeyCode0,
+            [AKEYCODE_1]               = GLFMKeyCode1,
+            [AKEYCODE_2]               = GLFMKeyCode2,
+            [AKEYCODE_3]               = GLFMKeyCode3,
+            [AKEYCODE_4]               = GLFMKeyCode4,
+            [AKEYCODE_5]               = GLFMKeyCode5,
+            [AKEYCODE_6]               = GLFMKeyCode6,
+            [AKEYCODE_7]               = GLFMKeyCode7,
+            [AKEYCODE_8]               = GLFMKeyCode8,
+            [AKEYCODE_9]               = GLFMKeyCode9,
+
+            [AKEYCODE_DPAD_UP]         = GLFMKeyCodeArrowUp,
+            [AKEYCODE_DPAD_DOWN]       = GLFMKeyCodeArrowDown,
+            [AKEYCODE_DPAD_LEFT]       = GLFMKeyCodeArrowLeft,
+            [AKEYCODE_DPAD_RIGHT]      = GLFMKeyCodeArrowRight,
+
+            [AKEYCODE_POWER]           = GLFMKeyCodePower,
+
+            [AKEYCODE_A]               = GLFMKeyCodeA,
+            [AKEYCODE_B]               = GLFMKeyCodeB,
+            [AKEYCODE_C]               = GLFMKeyCodeC,
+            [AKEYCODE_D]               = GLFMKeyCodeD,
+            [AKEYCODE_E]               = GLFMKeyCodeE,
+            [AKEYCODE_F]               = GLFMKeyCodeF,
+            [AKEYCODE_G]               = GLFMKeyCodeG,
+            [AKEYCODE_H]               = GLFMKeyCodeH,
+            [AKEYCODE_I]               = GLFMKeyCodeI,
+            [AKEYCODE_J]               = GLFMKeyCodeJ,
+            [AKEYCODE_K]               = GLFMKeyCodeK,
+            [AKEYCODE_L]               = GLFMKeyCodeL,
+            [AKEYCODE_M]               = GLFMKeyCodeM,
+            [AKEYCODE_N]               = GLFMKeyCodeN,
+            [AKEYCODE_O]               = GLFMKeyCodeO,
+            [AKEYCODE_P]               = GLFMKeyCodeP,
+            [AKEYCODE_Q]               = GLFMKeyCodeQ,
+            [AKEYCODE_R]               = GLFMKeyCodeR,
+            [AKEYCODE_S]               = GLFMKeyCodeS,
+            [AKEYCODE_T]               = GLFMKeyCodeT,
+            [AKEYCODE_U]               = GLFMKeyCodeU,
+            [AKEYCODE_V]               = GLFMKeyCodeV,
+            [AKEYCODE_W]               = GLFMKeyCodeW,
+            [AKEYCODE_X]               = GLFMKeyCodeX,
+            [AKEYCODE_Y]               = GLFMKeyCodeY,
+            [AKEYCODE_Z]               = GLFMKeyCodeZ,
+            [AKEYCODE_COMMA]           = GLFMKeyCodeComma,
+            [AKEYCODE_PERIOD]          = GLFMKeyCodePeriod,
+            [AKEYCODE_ALT_LEFT]        = GLFMKeyCodeAltLeft,
+            [AKEYCODE_ALT_RIGHT]       = GLFMKeyCodeAltRight,
+            [AKEYCODE_SHIFT_LEFT]      = GLFMKeyCodeShiftLeft,
+            [AKEYCODE_SHIFT_RIGHT]     = GLFMKeyCodeShiftRight,
+            [AKEYCODE_TAB]             = GLFMKeyCodeTab,
+            [AKEYCODE_SPACE]           = GLFMKeyCodeSpace,
+
+            [AKEYCODE_ENTER]           = GLFMKeyCodeEnter,
+            [AKEYCODE_DEL]             = GLFMKeyCodeBackspace,
+            [AKEYCODE_GRAVE]           = GLFMKeyCodeBackquote,
+            [AKEYCODE_MINUS]           = GLFMKeyCodeMinus,
+            [AKEYCODE_EQUALS]          = GLFMKeyCodeEqual,
+            [AKEYCODE_LEFT_BRACKET]    = GLFMKeyCodeBracketLeft,
+            [AKEYCODE_RIGHT_BRACKET]   = GLFMKeyCodeBracketRight,
+            [AKEYCODE_BACKSLASH]       = GLFMKeyCodeBackslash,
+            [AKEYCODE_SEMICOLON]       = GLFMKeyCodeSemicolon,
+            [AKEYCODE_APOSTROPHE]      = GLFMKeyCodeQuote,
+            [AKEYCODE_SLASH]           = GLFMKeyCodeSlash,
+
+            [AKEYCODE_MENU]            = GLFMKeyCodeMenu,
+
+            [AKEYCODE_PAGE_UP]         = GLFMKeyCodePageUp,
+            [AKEYCODE_PAGE_DOWN]       = GLFMKeyCodePageDown,
+
+            [AKEYCODE_ESCAPE]          = GLFMKeyCodeEscape,
+            [AKEYCODE_FORWARD_DEL]     = GLFMKeyCodeDelete,
+            [AKEYCODE_CTRL_LEFT]       = GLFMKeyCodeControlLeft,
+            [AKEYCODE_CTRL_RIGHT]      = GLFMKeyCodeControlRight,
+            [AKEYCODE_CAPS_LOCK]       = GLFMKeyCodeCapsLock,
+            [AKEYCODE_SCROLL_LOCK]     = GLFMKeyCodeScrollLock,
+            [AKEYCODE_META_LEFT]       = GLFMKeyCodeMetaLeft,
+            [AKEYCODE_META_RIGHT]      = GLFMKeyCodeMetaRight,
+            [AKEYCODE_FUNCTION]        = GLFMKeyCodeFunction,
+            [AKEYCODE_SYSRQ]           = GLFMKeyCodePrintScreen,
+            [AKEYCODE_BREAK]           = GLFMKeyCodePause,
+            [AKEYCODE_MOVE_HOME]       = GLFMKeyCodeHome,
+            [AKEYCODE_MOVE_END]        = GLFMKeyCodeEnd,
+            [AKEYCODE_INSERT]          = GLFMKeyCodeInsert,
+
+            [AKEYCODE_F1]              = GLFMKeyCodeF1,
+            [AKEYCODE_F2]              = GLFMKeyCodeF2,
+            [AKEYCODE_F3]              = GLFMKeyCodeF3,
+            [AKEYCODE_F4]              = GLFMKeyCodeF4,
+            [AKEYCODE_F5]              = GLFMKeyCodeF5,
+            [AKEYCODE_F6]              = GLFMKeyCodeF6,
+            [AKEYCODE_F7]              = GLFMKeyCodeF7,
+            [AKEYCODE_F8]              = GLFMKeyCodeF8,
+            [AKEYCODE_F9]              = GLFMKeyCodeF9,
+            [AKEYCODE_F10]             = GLFMKeyCodeF10,
+            [AKEYCODE_F11]             = GLFMKeyCodeF11,
+            [AKEYCODE_F12]             = GLFMKeyCodeF12,
+            [AKEYCODE_NUM_LOCK]        = GLFMKeyCodeNumLock,
+            [AKEYCODE_NUMPAD_0]        = GLFMKeyCodeNumpad0,
+            [AKEYCODE_NUMPAD_1]        = GLFMKeyCodeNumpad1,
+            [AKEYCODE_NUMPAD_2]        = GLFMKeyCodeNumpad2,
+            [AKEYCODE_NUMPAD_3]        = GLFMKeyCodeNumpad3,
+            [AKEYCODE_NUMPAD_4]        = GLFMKeyCodeNumpad4,
+            [AKEYCODE_NUMPAD_5]        = GLFMKeyCodeNumpad5,
+            [AKEYCODE_NUMPAD_6]        = GLFMKeyCodeNumpad6,
+            [AKEYCODE_NUMPAD_7]        = GLFMKeyCodeNumpad7,
+            [AKEYCODE_NUMPAD_8]        = GLFMKeyCodeNumpad8,
+            [AKEYCODE_NUMPAD_9]        = GLFMKeyCodeNumpad9,
+            [AKEYCODE_NUMPAD_DIVIDE]   = GLFMKeyCodeNumpadDivide,
+            [AKEYCODE_NUMPAD_MULTIPLY] = GLFMKeyCodeNumpadMultiply,
+            [AKEYCODE_NUMPAD_SUBTRACT] = GLFMKeyCodeNumpadSubtract,
+            [AKEYCODE_NUMPAD_ADD]      = GLFMKeyCodeNumpadAdd,
+            [AKEYCODE_NUMPAD_DOT]      = GLFMKeyCodeNumpadDecimal,
+            [AKEYCODE_NUMPAD_ENTER]    = GLFMKeyCodeNumpadEnter,
+            [AKEYCODE_NUMPAD_EQUALS]   = GLFMKeyCodeNumpadEqual,
+    };
 
-        GLFMKeyCode keyCode = GLFMKeyCodeUnknown;
-        if (aKeyCode >= 0 && aKeyCode < (int32_t)(sizeof(AKEYCODE_MAP) / sizeof(*AKEYCODE_MAP))) {
-            keyCode = AKEYCODE_MAP[aKeyCode];
-        }
+    GLFMKeyCode keyCode = GLFMKeyCodeUnknown;
+    if (aKeyCode >= 0 && aKeyCode < (int32_t)(sizeof(AKEYCODE_MAP) / sizeof(*AKEYCODE_MAP))) {
+        keyCode = AKEYCODE_MAP[aKeyCode];
+    }
 
-        int modifiers = 0;
-        if ((aMetaState & AMETA_SHIFT_ON) != 0) {
-            modifiers |= GLFMKeyModifierShift;
-        }
-        if ((aMetaState & AMETA_CTRL_ON) != 0) {
-            modifiers |= GLFMKeyModifierControl;
-        }
-        if ((aMetaState & AMETA_ALT_ON) != 0) {
-            modifiers |= GLFMKeyModifierAlt;
-        }
-        if ((aMetaState & AMETA_META_ON) != 0) {
-            modifiers |= GLFMKeyModifierMeta;
-        }
-        if ((aMetaState & AMETA_FUNCTION_ON) != 0) {
-            modifiers |= GLFMKeyModifierFunction;
-        }
+    int modifiers = 0;
+    if ((aMetaState & AMETA_SHIFT_ON) != 0) {
+        modifiers |= GLFMKeyModifierShift;
+    }
+    if ((aMetaState & AMETA_CTRL_ON) != 0) {
+        modifiers |= GLFMKeyModifierControl;
+    }
+    if ((aMetaState & AMETA_ALT_ON) != 0) {
+        modifiers |= GLFMKeyModifierAlt;
+    }
+    if ((aMetaState & AMETA_META_ON) != 0) {
+        modifiers |= GLFMKeyModifierMeta;
+    }
+    if ((aMetaState & AMETA_FUNCTION_ON) != 0) {
+        modifiers |= GLFMKeyModifierFunction;
+    }
 
-        if (aAction == AKEY_EVENT_ACTION_UP) {
-            handled = display->keyFunc(display, keyCode, GLFMKeyActionReleased, modifiers);
-        } else if (aAction == AKEY_EVENT_ACTION_DOWN) {
-            GLFMKeyAction keyAction;
-            if (AKeyEvent_getRepeatCount(event) > 0) {
-                keyAction = GLFMKeyActionRepeated;
-            } else {
-                keyAction = GLFMKeyActionPressed;
-            }
-            handled = display->keyFunc(display, keyCode, keyAction, modifiers);
-        } else if (aAction == AKEY_EVENT_ACTION_MULTIPLE) {
-            for (int i = AKeyEvent_getRepeatCount(event); i > 0; i--) {
-                if (display->keyFunc) {
-                    handled |= display->keyFunc(display, keyCode, GLFMKeyActionPressed, modifiers);
-                }
-                if (display->keyFunc) {
-                    handled |= display->keyFunc(display, keyCode, GLFMKeyActionReleased, modifiers);
-                }
-            }
+    if (aAction == AKEY_EVENT_ACTION_UP) {
+        handled = glfm__sendKeyEvent(display, keyCode, GLFMKeyActionReleased, modifiers);
+    } else if (aAction == AKEY_EVENT_ACTION_DOWN) {
+        GLFMKeyAction keyAction;
+        if (AKeyEvent_getRepeatCount(event) > 0) {
+            keyAction = GLFMKeyActionRepeated;
+        } else {
+            keyAction = GLFMKeyActionPressed;
+        }
+        handled = glfm__sendKeyEvent(display, keyCode, keyAction, modifiers);
+    } else if (aAction == AKEY_EVENT_ACTION_MULTIPLE) {
+        for (int i = AKeyEvent_getRepeatCount(event); i > 0; i--) {
+            handled |= glfm__sendKeyEvent(display, keyCode, GLFMKeyActionPressed, modifiers);
+            handled |= glfm__sendKeyEvent(display, keyCode, GLFMKeyActionReleased, modifiers);
         }
     }
 
@@ -1284,8 +1536,20 @@ static bool glfm__onKeyEvent(GLFMPlatformData *platformData, AInputEvent *event)
     return handled;
 }
 
+/// Converts an input event time, in nanoseconds, to the ``glfmGetTime`` timebase.
+static double glfm__getInputEventTime(int64_t eventTime) {
+    // Input event times use CLOCK_MONOTONIC (the same clock as SystemClock.uptimeMillis()), which may be a different
+    // clock than glfmGetTime()
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0) {
+        return glfmGetTime();
+    }
+    const int64_t nowNanos = (int64_t)now.tv_sec * 1000000000 + (int64_t)now.tv_nsec;
+    return glfmGetTime() + (double)(eventTime - nowNanos) / 1e9;
+}
+
 static bool glfm__onTouchEvent(GLFMPlatformData *platformData, AInputEvent *event) {
-    if (!platformData || !platformData->display || !platformData->display->touchFunc) {
+    if (!platformData || !platformData->display) {
         return false;
     }
     GLFMDisplay *display = platformData->display;
@@ -1318,14 +1582,23 @@ static bool glfm__onTouchEvent(GLFMPlatformData *platformData, AInputEvent *even
             break;
     }
     if (validAction) {
+        const double eventTime = glfm__getInputEventTime(AMotionEvent_getEventTime(event));
         if (phase == GLFMTouchPhaseMoved) {
             const size_t count = AMotionEvent_getPointerCount(event);
+            const size_t historySize = AMotionEvent_getHistorySize(event);
             for (size_t i = 0; i < count; i++) {
                 const int touchNumber = AMotionEvent_getPointerId(event, i);
-                if (touchNumber >= 0 && touchNumber < maxTouches && display->touchFunc) {
-                    double x = (double)AMotionEvent_getX(event, i);
-                    double y = (double)AMotionEvent_getY(event, i);
-                    display->touchFunc(display, touchNumber, phase, x, y);
+                if (touchNumber >= 0 && touchNumber < maxTouches) {
+                    // Moves batched since the previous event are only used for prediction
+                    for (size_t h = 0; h < historySize; h++) {
+                        double x = (double)AMotionEvent_getHistoricalX(event, i, h) * platformData->renderScale;
+                        double y = (double)AMotionEvent_getHistoricalY(event, i, h) * platformData->renderScale;
+                        double time = glfm__getInputEventTime(AMotionEvent_getHistoricalEventTime(event, h));
+                        glfm__recordTouch(display, touchNumber, phase, x, y, time);
+                    }
+                    double x = (double)AMotionEvent_getX(event, i) * platformData->renderScale;
+                    double y = (double)AMotionEvent_getY(event, i) * platformData->renderScale;
+                    glfm__sendTouchEvent(display, touchNumber, phase, x, y, eventTime);
                 }
             }
         } else {
@@ -1333,14 +1606,15 @@ static bool glfm__onTouchEvent(GLFMPlatformData *platformData, AInputEvent *even
                     (uint32_t)AMOTION_EVENT_ACTION_POINTER_INDEX_MASK) >>
                     (uint32_t)AMOTION_EVENT_ACTION_POINTER_INDEX_SHIFT);
             const int touchNumber = AMotionEvent_getPointerId(event, index);
-            if (touchNumber >= 0 && touchNumber < maxTouches && display->touchFunc) {
-                double x = (double)AMotionEvent_getX(event, index);
-                double y = (double)AMotionEvent_getY(event, index);
-                display->touchFunc(display, touchNumber, phase, x, y);
+            if (touchNumber >= 0 && touchNumber < maxTouches) {
+                double x = (double)AMotionEvent_getX(event, index) * platformData->renderScale;
+                double y = (double)AMotionEvent_getY(event, index) * platformData->renderScale;
+                glfm__sendTouchEvent(display, touchNumber, phase, x, y, eventTime);
             }
         }
     }
-    return true;
+    // Touches are always tracked for glfmGetTouchState, but are only consumed if the app has a touch function
+    return display->touchFunc != NULL;
 }
 
 static void glfm__onInputEvent(GLFMPlatformData *platformData) {
@@ -1364,145 +1638,215 @@ static void glfm__onInputEvent(GLFMPlatformData *platformData) {
     }
 }
 
-static void glfm__onSensorEvent(GLFMPlatformData *platformData) {
-    ASensorEvent event;
-    bool sensorEventReceived[GLFM_NUM_SENSORS] = { 0 };
-    while (ASensorEventQueue_getEvents(platformData->sensorEventQueue, &event, 1) > 0) {
-        if (event.type == ASENSOR_TYPE_ACCELEROMETER) {
-            // Convert to iOS format
-            GLFMSensorEvent *sensorEvent = &platformData->sensorEvent[GLFMSensorAccelerometer];
-            sensorEvent->sensor = GLFMSensorAccelerometer;
-            sensorEvent->timestamp = (double)event.timestamp / 1000000000.0;
-            sensorEvent->vector.x = (double)event.acceleration.x / -(double)ASENSOR_STANDARD_GRAVITY;
-            sensorEvent->vector.y = (double)event.acceleration.y / -(double)ASENSOR_STANDARD_GRAVITY;
-            sensorEvent->vector.z = (double)event.acceleration.z / -(double)ASENSOR_STANDARD_GRAVITY;
-            sensorEventReceived[GLFMSensorAccelerometer] = true;
-            platformData->sensorEventValid[GLFMSensorAccelerometer] = true;
-        } else if (event.type == ASENSOR_TYPE_MAGNETIC_FIELD) {
-            GLFMSensorEvent *sensorEvent = &platformData->sensorEvent[GLFMSensorMagnetometer];
-            sensorEvent->sensor = GLFMSensorMagnetometer;
-            sensorEvent->timestamp = (double)event.timestamp / 1000000000.0;
-            sensorEvent->vector.x = (double)event.magnetic.x;
-            sensorEvent->vector.y = (double)event.magnetic.y;
-            sensorEvent->vector.z = (double)event.magnetic.z;
-            sensorEventReceived[GLFMSensorMagnetometer] = true;
-            platformData->sensorEventValid[GLFMSensorMagnetometer] = true;
-        } else if (event.type == ASENSOR_TYPE_GYROSCOPE) {
-            GLFMSensorEvent *sensorEvent = &platformData->sensorEvent[GLFMSensorGyroscope];
-            sensorEvent->sensor = GLFMSensorGyroscope;
-            sensorEvent->timestamp = (double)event.timestamp / 1000000000.0;
-            sensorEvent->vector.x = (double)event.vector.x;
-            sensorEvent->vector.y = (double)event.vector.y;
-            sensorEvent->vector.z = (double)event.vector.z;
-            sensorEventReceived[GLFMSensorGyroscope] = true;
-            platformData->sensorEventValid[GLFMSensorGyroscope] = true;
-        } else if (event.type == ASENSOR_TYPE_ROTATION_VECTOR) {
-            const int SDK_INT = platformData->activity->sdkVersion;
-
-            GLFMSensorEvent *sensorEvent = &platformData->sensorEvent[GLFMSensorRotationMatrix];
-            sensorEvent->sensor = GLFMSensorRotationMatrix;
-            sensorEvent->timestamp = (double)event.timestamp / 1000000000.0;
-
-            // Get unit quaternion
-            double qx = (double)event.vector.x;
-            double qy = (double)event.vector.y;
-            double qz = (double)event.vector.z;
-            double qw;
-            if (SDK_INT >= 18) {
-                qw = (double)event.data[3];
-            } else {
-                qw = 1 - (qx * qx + qy * qy + qz * qz);
-                qw = (qw > 0) ? sqrt(qw) : 0;
-            }
-
-            /*
-             * Convert unit quaternion to rotation matrix.
-             *
-             * First, convert Android's reference frame to the same as iOS.
-             * Android uses a reference frame where the Y axis points north,
-             * and iOS uses a reference frame where the X axis points north.
-             *
-             * To convert the unit quaternion, pre-multiply the unit quaternion by
-             * a rotation of -90 degrees around the Z axis.
-             *
-             * a=-90
-             * q1 = cos(a/2) + 0i + 0j + sin(a/2)k
-             *
-             * Which is the same as:
-             *
-             * f = sqrt(2)/2
-             * q1 = f + 0i + 0j - fk
-             *
-             * Multiplying two quaternions, where q2 is the original Android quaternion:
-             *
-             * q1q2 = (w1w2 - x1x2 - y1y2 - z1z2) +
-             *        (w1x2 + x1w2 + y1z2 - z1y2)i +
-             *        (w1y2 + z1x2 + y1w2 - x1z2)j +
-             *        (w1z2 + x1y2 + z1w2 - y1x2)k
-             *
-             * Where x1 == 0, y1 == 0, z1 == -f, w1 == f:
-             *
-             * q1q2 = (f * (z2 + w2)) +
-             *        (f * (y2 + x2))i +
-             *        (f * (y2 - x2))j +
-             *        (f * (z2 + w2))k
-             *
-             * In C:
-             *
-             * double f = sqrt(2)/2;
-             * double qx_ = f * (qy + qx);
-             * double qy_ = f * (qy - qx);
-             * double qz_ = f * (qz - qw);
-             * double qw_ = f * (qz + qw);
-             *
-             * However, since f*f == 0.5, and we don't need the converted quaternion,
-             * we can remove a few multiplications.
-            */
+/// Converts an Android sensor event to a GLFMSensorEvent. Returns false if the sensor type is unknown.
+static bool glfm__convertSensorEvent(const GLFMPlatformData *platformData, const ASensorEvent *event,
+                                     GLFMSensorEvent *sensorEvent) {
+    if (event->type == ASENSOR_TYPE_ACCELEROMETER) {
+        // Convert to iOS format
+        sensorEvent->sensor = GLFMSensorAccelerometer;
+        sensorEvent->timestamp = (double)event->timestamp / 1000000000.0;
+        sensorEvent->vector.x = (double)event->acceleration.x / -(double)ASENSOR_STANDARD_GRAVITY;
+        sensorEvent->vector.y = (double)event->acceleration.y / -(double)ASENSOR_STANDARD_GRAVITY;
+        sensorEvent->vector.z = (double)event->acceleration.z / -(double)ASENSOR_STANDARD_GRAVITY;
+        return true;
+    } else if (event->type == ASENSOR_TYPE_MAGNETIC_FIELD) {
+        sensorEvent->sensor = GLFMSensorMagnetometer;
+        sensorEvent->timestamp = (double)event->timestamp / 1000000000.0;
+        sensorEvent->vector.x = (double)event->magnetic.x;
+        sensorEvent->vector.y = (double)event->magnetic.y;
+        sensorEvent->vector.z = (double)event->magnetic.z;
+        return true;
+    } else if (event->type == ASENSOR_TYPE_GYROSCOPE) {
+        sensorEvent->sensor = GLFMSensorGyroscope;
+        sensorEvent->timestamp = (double)event->timestamp / 1000000000.0;
+        sensorEvent->vector.x = (double)event->vector.x;
+        sensorEvent->vector.y = (double)event->vector.y;
+        sensorEvent->vector.z = (double)event->vector.z;
+        return true;
+    } else if (event->type == ASENSOR_TYPE_ROTATION_VECTOR) {
+        const int SDK_INT = platformData->activity->sdkVersion;
+
+        sensorEvent->sensor = GLFMSensorRotationMatrix;
+        sensorEvent->timestamp = (double)event->timestamp / 1000000000.0;
+
+        // Get unit quaternion
+        double qx = (double)event->vector.x;
+        double qy = (double)event->vector.y;
+        double qz = (double)event->vector.z;
+        double qw;
+        if (SDK_INT >= 18) {
+            qw = (double)event->data[3];
+        } else {
+            qw = 1 - (qx * qx + qy * qy + qz * qz);
+            qw = (qw > 0) ? sqrt(qw) : 0;
+        }
+
+        /*
+         * Convert unit quaternion to rotation matrix.
+         *
+         * First, convert Android's reference frame to the same as iOS.
+         * Android uses a reference frame where the Y axis points north,
+         * and iOS uses a reference frame where the X axis points north.
+         *
+         * To convert the unit quaternion, pre-multiply the unit quaternion by
+         * a rotation of -90 degrees around the Z axis.
+         *
+         * a=-90
+         * q1 = cos(a/2) + 0i + 0j + sin(a/2)k
+         *
+         * Which is the same as:
+         *
+         * f = sqrt(2)/2
+         * q1 = f + 0i + 0j - fk
+         *
+         * Multiplying two quaternions, where q2 is the original Android quaternion:
+         *
+         * q1q2 = (w1w2 - x1x2 - y1y2 - z1z2) +
+         *        (w1x2 + x1w2 + y1z2 - z1y2)i +
+         *        (w1y2 + z1x2 + y1w2 - x1z2)j +
+         *        (w1z2 + x1y2 + z1w2 - y1x2)k
+         *
+         * Where x1 == 0, y1 == 0, z1 == -f, w1 == f:
+         *
+         * q1q2 = (f * (z2 + w2)) +
+         *        (f * (y2 + x2))i +
+         *        (f * (y2 - x2))j +
+         *        (f * (z2 + w2))k
+         *
+         * In C:
+         *
+         * double f = sqrt(2)/2;
+         * double qx_ = f * (qy + qx);
+         * double qy_ = f * (qy - qx);
+         * double qz_ = f * (qz - qw);
+         * double qw_ = f * (qz + qw);
+         *
+         * However, since f*f == 0.5, and we don't need the converted quaternion,
+         * we can remove a few multiplications.
+        */
 #if 0
-            // Original (no conversion)
-            double qxx2 = qx * qx * 2;
-            double qxy2 = qx * qy * 2;
-            double qxz2 = qx * qz * 2;
-            double qxw2 = qx * qw * 2;
-            double qyy2 = qy * qy * 2;
-            double qyz2 = qy * qz * 2;
-            double qyw2 = qy * qw * 2;
-            double qzz2 = qz * qz * 2;
-            double qzw2 = qz * qw * 2;
+        // Original (no conversion)
+        double qxx2 = qx * qx * 2;
+        double qxy2 = qx * qy * 2;
+        double qxz2 = qx * qz * 2;
+        double qxw2 = qx * qw * 2;
+        double qyy2 = qy * qy * 2;
+        double qyz2 = qy * qz * 2;
+        double qyw2 = qy * qw * 2;
+        double qzz2 = qz * qz * 2;
+        double qzw2 = qz * qw * 2;
 #else
-            // Conversion to the same reference frame as iOS
-            double qx_ = qy + qx;
-            double qy_ = qy - qx;
-            double qz_ = qz - qw;
-            double qw_ = qz + qw;
-
-            double qxx2 = qx_ * qx_;
-            double qxy2 = qx_ * qy_;
-            double qxz2 = qx_ * qz_;
-            double qxw2 = qx_ * qw_;
-            double qyy2 = qy_ * qy_;
-            double qyz2 = qy_ * qz_;
-            double qyw2 = qy_ * qw_;
-            double qzz2 = qz_ * qz_;
-            double qzw2 = qz_ * qw_;
+        // Conversion to the same reference frame as iOS
+        double qx_ = qy + qx;
+        double qy_ = qy - qx;
+        double qz_ = qz - qw;
+        double qw_ = qz + qw;
+
+        double qxx2 = qx_ * qx_;
+        double qxy2 = qx_ * qy_;
+        double qxz2 = qx_ * qz_;
+        double qxw2 = qx_ * qw_;
+        double qyy2 = qy_ * qy_;
+        double qyz2 = qy_ * qz_;
+        double qyw2 = qy_ * qw_;
+        double qzz2 = qz_ * qz_;
+        double qzw2 = qz_ * qw_;
 #endif
-            sensorEvent->matrix.m00 = 1 - qyy2 - qzz2;
-            sensorEvent->matrix.m10 = qxy2 - qzw2;
-            sensorEvent->matrix.m20 = qxz2 + qyw2;
-            sensorEvent->matrix.m01 = qxy2 + qzw2;
-            sensorEvent->matrix.m11 = 1 - qxx2 - qzz2;
-            sensorEvent->matrix.m21 = qyz2 - qxw2;
-            sensorEvent->matrix.m02 = qxz2 - qyw2;
-            sensorEvent->matrix.m12 = qyz2 + qxw2;
-            sensorEvent->matrix.m22 = 1 - qxx2 - qyy2;
+        sensorEvent->matrix.m00 = 1 - qyy2 - qzz2;
+        sensorEvent->matrix.m10 = qxy2 - qzw2;
+        sensorEvent->matrix.m20 = qxz2 + qyw2;
+        sensorEvent->matrix.m01 = qxy2 + qzw2;
+        sensorEvent->matrix.m11 = 1 - qxx2 - qzz2;
+        sensorEvent->matrix.m21 = qyz2 - qxw2;
+        sensorEvent->matrix.m02 = qxz2 - qyw2;
+        sensorEvent->matrix.m12 = qyz2 + qxw2;
+        sensorEvent->matrix.m22 = 1 - qxx2 - qyy2;
+        return true;
+    }
+    return false;
+}
+
+static void glfm__flushSensorEventBatch(GLFMPlatformData *platformData, int index) {
+    const int count = platformData->sensorEventBatchCount[index];
+    platformData->sensorEventBatchCount[index] = 0;
+    GLFMSensorBatchFunc batchFunc = platformData->display->sensorBatchFuncs[index];
+    if (batchFunc && count > 0) {
+        batchFunc(platformData->display, platformData->sensorEventBatch[index], count);
+    }
+}
 
-            sensorEventReceived[GLFMSensorRotationMatrix] = true;
-            platformData->sensorEventValid[GLFMSensorRotationMatrix] = true;
+static void glfm__queueSensorEvent(GLFMPlatformData *platformData, const GLFMSensorEvent *sensorEvent,
+                                   bool sensorEventReceived[GLFM_NUM_SENSORS]) {
+    const int index = (int)sensorEvent->sensor;
+    platformData->sensorEvent[index] = *sensorEvent;
+    platformData->sensorEventValid[index] = true;
+    glfm__addSensorHistory(platformData->display, sensorEvent);
+    sensorEventReceived[index] = true;
+    if (platformData->display->sensorBatchFuncs[index]) {
+        if (platformData->sensorEventBatchCount[index] >= GLFM_SENSOR_EVENT_BATCH_SIZE) {
+            glfm__flushSensorEventBatch(platformData, index);
+        }
+        platformData->sensorEventBatch[index][platformData->sensorEventBatchCount[index]++] = *sensorEvent;
+    }
+}
+
+/// Adds a sensor event to the sensor fusion filter. If the orientation was updated, sets `rotationEvent` and returns
+/// true.
+static bool glfm__updateSensorFusionWithEvent(GLFMPlatformData *platformData, const GLFMSensorEvent *sensorEvent,
+                                              GLFMSensorEvent *rotationEvent) {
+    GLFMSensorFusion *fusion = &platformData->sensorFusion;
+    switch (sensorEvent->sensor) {
+        case GLFMSensorAccelerometer:
+            glfm__setSensorFusionAcceleration(fusion, sensorEvent->vector.x, sensorEvent->vector.y,
+                                              sensorEvent->vector.z);
+            return false;
+        case GLFMSensorMagnetometer:
+            glfm__setSensorFusionMagneticField(fusion, sensorEvent->vector.x, sensorEvent->vector.y,
+                                               sensorEvent->vector.z);
+            return false;
+        case GLFMSensorGyroscope:
+            if (!glfm__updateSensorFusion(fusion, sensorEvent->timestamp, sensorEvent->vector.x,
+                                          sensorEvent->vector.y, sensorEvent->vector.z)) {
+                return false;
+            }
+            break;
+        case GLFMSensorRotationMatrix: default:
+            return false;
+    }
+
+    GLFMDisplay *display = platformData->display;
+    glfm__getSensorFusionQuaternion(fusion, display->sensorFusionQuaternion);
+    display->sensorFusionQuaternionValid = true;
+    memset(rotationEvent, 0, sizeof(GLFMSensorEvent));
+    rotationEvent->sensor = GLFMSensorRotationMatrix;
+    rotationEvent->timestamp = sensorEvent->timestamp;
+    glfm__setSensorQuaternion(rotationEvent, display->sensorFusionQuaternion);
+    return true;
+}
+
+static void glfm__onSensorEvent(GLFMPlatformData *platformData) {
+    ASensorEvent events[GLFM_SENSOR_EVENT_BATCH_SIZE];
+    bool sensorEventReceived[GLFM_NUM_SENSORS] = { 0 };
+    ssize_t count;
+    while ((count = ASensorEventQueue_getEvents(platformData->sensorEventQueue, events,
+                                                GLFM_SENSOR_EVENT_BATCH_SIZE)) > 0) {
+        for (ssize_t i = 0; i < count; i++) {
+            GLFMSensorEvent sensorEvent = { 0 };
+            if (!glfm__convertSensorEvent(platformData, &events[i], &sensorEvent)) {
+                continue;
+            }
+            glfm__queueSensorEvent(platformData, &sensorEvent, sensorEventReceived);
+            GLFMSensorEvent rotationEvent;
+            if (platformData->sensorFusionInUse &&
+                glfm__updateSensorFusionWithEvent(platformData, &sensorEvent, &rotationEvent)) {
+                glfm__queueSensorEvent(platformData, &rotationEvent, sensorEventReceived);
+            }
         }
     }
 
     // Send callbacks
     for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+        glfm__flushSensorEventBatch(platformData, i);
         GLFMSensorFunc sensorFunc = platformData->display->sensorFuncs[i];
         if (sensorFunc && sensorEventReceived[i]) {
             sensorFunc(platformData->display, platformData->sensorEvent[i]);
@@ -1548,6 +1892,8 @@ static void *glfm__mainLoop(void *param) {
         platformData->display->platformData = platformData;
         platformData->display->supportedOrientations = GLFMInterfaceOrientationAll;
         platformData->display->swapBehavior = GLFMSwapBehaviorPlatformDefault;
+        platformData->display->renderScale = 1.0;
+        platformData->renderScale = 1.0;
         platformData->resizeEventWaitFrames = GLFM_RESIZE_EVENT_MAX_WAIT_FRAMES;
         glfmMain(platformData->display);
     }
@@ -1660,11 +2006,12 @@ static void *glfm__mainLoop(void *param) {
         ASensorManager_destroyEventQueue(sensorManager, platformData->sensorEventQueue);
         platformData->sensorEventQueue = NULL;
     }
+    glfm__destroyAllSensorDirectChannels(platformData);
     if (platformData->config) {
         AConfiguration_delete(platformData->config);
         platformData->config = NULL;
     }
-    glfm__eglDestroy(platformData);
+    glfm__eglRelease(platformData);
     glfm__setAnimating(platformData, false);
     (*jvm)->DetachCurrentThread(jvm);
     platformData->window = NULL;
@@ -2047,6 +2394,12 @@ static bool glfm__updateSurfaceSizeIfNeeded(GLFMDisplay *display, bool force) {
     EGLBoolean success = true;
     success &= eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_WIDTH, &width);
     success &= eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_HEIGHT, &height);
+    if (glfm__isPreTransformRotated(platformData->preTransform)) {
+        // Report the logical size
+        int32_t surfaceWidth = width;
+        width = height;
+        height = surfaceWidth;
+    }
     if (success && (width != platformData->width || height != platformData->height)) {
         if (force || platformData->resizeEventWaitFrames <= 0) {
             GLFM_LOG_LIFECYCLE("Resize: %i x %i", width, height);
@@ -2075,25 +2428,36 @@ static void glfm__getDisplayChromeInsets(const GLFMDisplay *display, int *top, i
     } else {
         success = glfm__getSystemWindowInsets(display, top, right, bottom, left);
     }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    const double renderScale = platformData->renderScale;
     if (!success) {
-        GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
         const ARect *contentRect = &platformData->contentRectArray[platformData->contentRectIndex];
         ARect visibleRect = glfm__getWindowVisibleDisplayFrame(platformData, contentRect);
+        // The visible display frame is in window pixels, which differ from surface pixels when the render scale is
+        // less than 1.
+        const int32_t windowWidth = (int32_t)(platformData->width / renderScale + 0.5);
+        const int32_t windowHeight = (int32_t)(platformData->height / renderScale + 0.5);
         // When rotating on some devices (API 16), the dimensions and visible display frame may be out of sync
         // for a moment. Report insets of 0 when this happens.
         if (visibleRect.right - visibleRect.left <= 0 || visibleRect.bottom - visibleRect.top <= 0 ||
-            visibleRect.right > platformData->width || visibleRect.bottom > platformData->height) {
+            visibleRect.right > windowWidth || visibleRect.bottom > windowHeight) {
             *top = 0;
             *right = 0;
             *bottom = 0;
             *left = 0;
         } else {
             *top = visibleRect.top;
-            *right = platformData->width - visibleRect.right;
-            *bottom = platformData->height - visibleRect.bottom;
+            *right = windowWidth - visibleRect.right;
+            *bottom = windowHeight - visibleRect.bottom;
             *left = visibleRect.left;
         }
     }
+    if (renderScale < 1.0) {
+        *top = (int)(*top * renderScale + 0.5);
+        *right = (int)(*right * renderScale + 0.5);
+        *bottom = (int)(*bottom * renderScale + 0.5);
+        *left = (int)(*left * renderScale + 0.5);
+    }
 }
 
 static void glfm__reportInsetsChangedIfNeeded(GLFMDisplay *display) {
@@ -2185,22 +2549,241 @@ static const ASensor *glfm__getDeviceSensor(GLFMSensor sensor) {
     }
 }
 
+// MARK: - Sensor direct channels
+
+static bool glfm__loadSensorDirectChannelFuncs(GLFMPlatformData *platformData) {
+    if (!platformData->sensorDirectChannelFuncsChecked) {
+        platformData->sensorDirectChannelFuncsChecked = true;
+        if (platformData->activity && platformData->activity->sdkVersion >= 26) {
+            platformData->sensorDirectChannelFuncs.isDirectChannelTypeSupported =
+                (GLFMASensorIsDirectChannelTypeSupportedProc)dlsym(RTLD_DEFAULT,
+                                                                   "ASensor_isDirectChannelTypeSupported");
+            platformData->sensorDirectChannelFuncs.getHighestDirectReportRateLevel =
+                (GLFMASensorGetHighestDirectReportRateLevelProc)dlsym(RTLD_DEFAULT,
+                                                                      "ASensor_getHighestDirectReportRateLevel");
+            platformData->sensorDirectChannelFuncs.createSharedMemoryDirectChannel =
+                (GLFMASensorManagerCreateSharedMemoryDirectChannelProc)dlsym(RTLD_DEFAULT,
+                    "ASensorManager_createSharedMemoryDirectChannel");
+            platformData->sensorDirectChannelFuncs.destroyDirectChannel =
+                (GLFMASensorManagerDestroyDirectChannelProc)dlsym(RTLD_DEFAULT, "ASensorManager_destroyDirectChannel");
+            platformData->sensorDirectChannelFuncs.configureDirectReport =
+                (GLFMASensorManagerConfigureDirectReportProc)dlsym(RTLD_DEFAULT,
+                                                                   "ASensorManager_configureDirectReport");
+            platformData->sensorDirectChannelFuncs.sharedMemoryCreate =
+                (GLFMASharedMemoryCreateProc)dlsym(RTLD_DEFAULT, "ASharedMemory_create");
+        }
+    }
+    return (platformData->sensorDirectChannelFuncs.isDirectChannelTypeSupported &&
+            platformData->sensorDirectChannelFuncs.getHighestDirectReportRateLevel &&
+            platformData->sensorDirectChannelFuncs.createSharedMemoryDirectChannel &&
+            platformData->sensorDirectChannelFuncs.destroyDirectChannel &&
+            platformData->sensorDirectChannelFuncs.configureDirectReport &&
+            platformData->sensorDirectChannelFuncs.sharedMemoryCreate);
+}
+
+static const ASensor *glfm__getDirectChannelSensor(GLFMPlatformData *platformData, GLFMSensor sensor) {
+    if (sensor != GLFMSensorAccelerometer && sensor != GLFMSensorMagnetometer && sensor != GLFMSensorGyroscope) {
+        return NULL;
+    }
+    if (!glfm__loadSensorDirectChannelFuncs(platformData)) {
+        return NULL;
+    }
+    const ASensor *deviceSensor = glfm__getDeviceSensor(sensor);
+    if (!deviceSensor ||
+        !platformData->sensorDirectChannelFuncs.isDirectChannelTypeSupported(deviceSensor,
+                                                                             ASENSOR_DIRECT_CHANNEL_TYPE_SHARED_MEMORY) ||
+        platformData->sensorDirectChannelFuncs.getHighestDirectReportRateLevel(deviceSensor) <
+        ASENSOR_DIRECT_RATE_NORMAL) {
+        return NULL;
+    }
+    return deviceSensor;
+}
+
+static void glfm__setSensorDirectChannelActive(GLFMPlatformData *platformData, int index, bool active) {
+    GLFMSensorDirectChannel *channel = &platformData->sensorDirectChannels[index];
+    if (channel->channelId <= 0 || channel->active == active) {
+        return;
+    }
+    const ASensor *deviceSensor = glfm__getDeviceSensor((GLFMSensor)index);
+    if (!deviceSensor) {
+        return;
+    }
+    int rate = ASENSOR_DIRECT_RATE_STOP;
+    if (active) {
+        rate = platformData->sensorDirectChannelFuncs.getHighestDirectReportRateLevel(deviceSensor);
+    }
+    ASensorManager *sensorManager = ASensorManager_getInstance();
+    int result = platformData->sensorDirectChannelFuncs.configureDirectReport(sensorManager, deviceSensor,
+                                                                              channel->channelId, rate);
+    if (result >= 0) {
+        channel->active = active;
+    }
+}
+
+static void glfm__destroySensorDirectChannel(GLFMPlatformData *platformData, int index) {
+    GLFMSensorDirectChannel *channel = &platformData->sensorDirectChannels[index];
+    if (channel->channelId > 0) {
+        glfm__setSensorDirectChannelActive(platformData, index, false);
+        ASensorManager *sensorManager = ASensorManager_getInstance();
+        platformData->sensorDirectChannelFuncs.destroyDirectChannel(sensorManager, channel->channelId);
+    }
+    if (channel->events) {
+        munmap((void *)channel->events, GLFM_SENSOR_DIRECT_CHANNEL_EVENT_COUNT * sizeof(ASensorEvent));
+    }
+    if (channel->fd > 0) {
+        close(channel->fd);
+    }
+    memset(channel, 0, sizeof(GLFMSensorDirectChannel));
+}
+
+static void glfm__destroyAllSensorDirectChannels(GLFMPlatformData *platformData) {
+    for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+        glfm__destroySensorDirectChannel(platformData, i);
+    }
+}
+
+static bool glfm__createSensorDirectChannel(GLFMPlatformData *platformData, int index) {
+    GLFMSensorDirectChannel *channel = &platformData->sensorDirectChannels[index];
+    const size_t size = GLFM_SENSOR_DIRECT_CHANNEL_EVENT_COUNT * sizeof(ASensorEvent);
+    channel->fd = platformData->sensorDirectChannelFuncs.sharedMemoryCreate("glfm-sensor", size);
+    if (channel->fd <= 0) {
+        glfm__destroySensorDirectChannel(platformData, index);
+        return false;
+    }
+    void *events = mmap(NULL, size, PROT_READ, MAP_SHARED, channel->fd, 0);
+    if (events == MAP_FAILED) {
+        glfm__destroySensorDirectChannel(platformData, index);
+        return false;
+    }
+    channel->events = events;
+    ASensorManager *sensorManager = ASensorManager_getInstance();
+    channel->channelId = platformData->sensorDirectChannelFuncs.createSharedMemoryDirectChannel(sensorManager,
+                                                                                               channel->fd, size);
+    if (channel->channelId <= 0) {
+        glfm__destroySensorDirectChannel(platformData, index);
+        return false;
+    }
+    glfm__setSensorDirectChannelActive(platformData, index, platformData->animating);
+    if (platformData->animating && !channel->active) {
+        glfm__destroySensorDirectChannel(platformData, index);
+        return false;
+    }
+    return true;
+}
+
+static GLFMASensorEventQueueRegisterSensorProc glfm__getRegisterSensorFunc(GLFMPlatformData *platformData) {
+    if (!platformData->registerSensorChecked) {
+        platformData->registerSensorChecked = true;
+        platformData->registerSensor = NULL;
+        if (platformData->activity && platformData->activity->sdkVersion >= 26) {
+            platformData->registerSensor =
+                (GLFMASensorEventQueueRegisterSensorProc)dlsym(RTLD_DEFAULT, "ASensorEventQueue_registerSensor");
+        }
+    }
+    return platformData->registerSensor;
+}
+
+static int32_t glfm__getSensorPeriodMicros(const GLFMDisplay *display, int index, const ASensor *deviceSensor) {
+    int32_t period = GLFM_SENSOR_UPDATE_INTERVAL_MICROS;
+    if (display->sensorRates[index] > 0.0) {
+        const double requestedPeriod = 1000000.0 / display->sensorRates[index];
+        period = requestedPeriod < 1.0 ? 1 : (int32_t)requestedPeriod;
+    }
+    const int minDelay = ASensor_getMinDelay(deviceSensor);
+    if (period < minDelay) {
+        period = minDelay;
+    }
+    return period;
+}
+
+static int64_t glfm__getSensorLatencyMicros(const GLFMDisplay *display, int index) {
+    return (int64_t)(display->sensorMaxLatencies[index] * 1000000.0);
+}
+
+static bool glfm__enableDeviceSensor(GLFMPlatformData *platformData, int index, const ASensor *deviceSensor) {
+    GLFMDisplay *display = platformData->display;
+    const int32_t period = glfm__getSensorPeriodMicros(display, index, deviceSensor);
+    const int64_t latency = glfm__getSensorLatencyMicros(display, index);
+    const bool streaming = ASensor_getMinDelay(deviceSensor) > 0;
+    GLFMASensorEventQueueRegisterSensorProc registerSensor = glfm__getRegisterSensorFunc(platformData);
+    bool enabled;
+    if (registerSensor && streaming) {
+        enabled = registerSensor(platformData->sensorEventQueue, deviceSensor, period, latency) == 0;
+    } else {
+        enabled = ASensorEventQueue_enableSensor(platformData->sensorEventQueue, deviceSensor) == 0;
+        if (enabled && streaming) {
+            ASensorEventQueue_setEventRate(platformData->sensorEventQueue, deviceSensor, period);
+        }
+    }
+    if (enabled) {
+        platformData->deviceSensorEnabled[index] = true;
+        platformData->deviceSensorPeriodMicros[index] = period;
+        platformData->deviceSensorLatencyMicros[index] = latency;
+    }
+    return enabled;
+}
+
+/// Returns true if the rotation sensor should be computed from the accelerometer, gyroscope, and magnetometer.
+static bool glfm__isSensorFusionAvailable(const GLFMDisplay *display) {
+    if (!display || display->sensorFusionMode == GLFMSensorFusionModeDisabled ||
+        !glfm__getDeviceSensor(GLFMSensorAccelerometer) || !glfm__getDeviceSensor(GLFMSensorGyroscope)) {
+        return false;
+    }
+    return (display->sensorFusionMode == GLFMSensorFusionModeAlways ||
+            !glfm__getDeviceSensor(GLFMSensorRotationMatrix));
+}
+
+/// Returns true if the device sensor at `index` needs to be enabled for the requested sensors.
+static bool glfm__isDeviceSensorNeeded(const GLFMDisplay *display, bool useSensorFusion, int index) {
+    if (useSensorFusion) {
+        if (index == GLFMSensorRotationMatrix) {
+            return false;
+        } else if (glfm__isSensorRequested(display, GLFMSensorRotationMatrix)) {
+            return true;
+        }
+    }
+    return glfm__isSensorRequested(display, index);
+}
+
 static void glfm__setAllRequestedSensorsEnabled(GLFMDisplay *display, bool enabledGlobally) {
     if (!display) {
         return;
     }
     GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    const bool useSensorFusion = glfm__isSensorFusionAvailable(display);
+    const bool sensorFusionInUse = (enabledGlobally && useSensorFusion &&
+                                    glfm__isSensorRequested(display, GLFMSensorRotationMatrix));
+    if (platformData->sensorFusionInUse != sensorFusionInUse) {
+        platformData->sensorFusionInUse = sensorFusionInUse;
+        glfm__resetSensorFusion(&platformData->sensorFusion);
+        display->sensorFusionQuaternionValid = false;
+    }
     for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
         GLFMSensor sensor = (GLFMSensor)i;
         const ASensor *deviceSensor = glfm__getDeviceSensor(sensor);
-        bool isNeededEnabled = display->sensorFuncs[i] != NULL;
+        bool isNeededEnabled = glfm__isDeviceSensorNeeded(display, useSensorFusion, i);
         bool shouldEnable = enabledGlobally && isNeededEnabled;
         bool isEnabled = platformData->deviceSensorEnabled[i];
-        if (!shouldEnable) {
+        if (!enabledGlobally || !glfm__isSensorRequested(display, i)) {
             platformData->sensorEventValid[i] = false;
+            glfm__clearSensorHistory(display, i);
+        }
+        if (deviceSensor == NULL) {
+            continue;
         }
 
-        if (isEnabled == shouldEnable || deviceSensor == NULL) {
+        // Re-register the sensor if the rate or latency changed while enabled
+        if (isEnabled && shouldEnable && platformData->sensorEventQueue &&
+            (platformData->deviceSensorPeriodMicros[i] != glfm__getSensorPeriodMicros(display, i, deviceSensor) ||
+             platformData->deviceSensorLatencyMicros[i] != glfm__getSensorLatencyMicros(display, i))) {
+            if (ASensorEventQueue_disableSensor(platformData->sensorEventQueue, deviceSensor) == 0) {
+                platformData->deviceSensorEnabled[i] = false;
+                glfm__enableDeviceSensor(platformData, i, deviceSensor);
+            }
+            continue;
+        }
+
+        if (isEnabled == shouldEnable) {
             continue;
         }
         if (platformData->sensorEventQueue == NULL) {
@@ -2212,24 +2795,16 @@ static void glfm__setAllRequestedSensorsEnabled(GLFMDisplay *display, bool enabl
             }
         }
         if (shouldEnable && !isEnabled) {
-            if (ASensorEventQueue_enableSensor(platformData->sensorEventQueue, deviceSensor) == 0) {
-                int minDelay = ASensor_getMinDelay(deviceSensor);
-                if (minDelay > 0) {
-                    int delay = GLFM_SENSOR_UPDATE_INTERVAL_MICROS;
-                    if (delay < minDelay) {
-                        delay = minDelay;
-                    }
-                    ASensorEventQueue_setEventRate(platformData->sensorEventQueue, deviceSensor,
-                                                   delay);
-                }
-                platformData->deviceSensorEnabled[i] = true;
-            }
+            glfm__enableDeviceSensor(platformData, i, deviceSensor);
         } else if (!shouldEnable && isEnabled) {
             if (ASensorEventQueue_disableSensor(platformData->sensorEventQueue, deviceSensor) == 0) {
                 platformData->deviceSensorEnabled[i] = false;
             }
         }
     }
+    for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+        glfm__setSensorDirectChannelActive(platformData, i, enabledGlobally);
+    }
 }
 
 static void glfm__sensorFuncUpdated(GLFMDisplay *display) {
@@ -2239,6 +2814,40 @@ static void glfm__sensorFuncUpdated(GLFMDisplay *display) {
     }
 }
 
+static void glfm__inputFuncUpdated(GLFMDisplay *display) {
+    (void)display;
+}
+
+static void glfm__hiddenFrameRateUpdated(GLFMDisplay *display) {
+    (void)display;
+}
+
+static char *glfm__copySupportedExtensions(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    if (!platformData || !platformData->eglContextCurrent) {
+        return NULL;
+    }
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+    if (!extensions) {
+        return NULL;
+    }
+    char *copy = malloc(strlen(extensions) + 1);
+    if (copy) {
+        strcpy(copy, extensions);
+    }
+    return copy;
+}
+
+static double glfm__getSensorTimestamp(double time) {
+    // Sensor timestamps use the same clock as SystemClock.elapsedRealtimeNanos()
+    struct timespec now;
+    if (clock_gettime(CLOCK_BOOTTIME, &now) != 0) {
+        return time;
+    }
+    const double sensorNow = (double)now.tv_sec + (double)now.tv_nsec / 1000000000.0;
+    return time + (sensorNow - glfmGetTime());
+}
+
 /// Gets an Android system service. The "serviceName" is a field from android.content.Context, like
 /// "INPUT_METHOD_SERVICE" or "VIBRATOR_SERVICE".
 ///
@@ -2370,10 +2979,11 @@ static void glfm__updateKeyboardVisibility(GLFMPlatformData *platformData) {
             platformData->keyboardFrame = keyboardFrame;
             platformData->refreshRequested = true;
             if (platformData->display->keyboardVisibilityChangedFunc) {
-                double x = keyboardFrame.left;
-                double y = keyboardFrame.top;
-                double width = keyboardFrame.right - keyboardFrame.left;
-                double height = keyboardFrame.bottom - keyboardFrame.top;
+                const double renderScale = platformData->renderScale;
+                double x = keyboardFrame.left * renderScale;
+                double y = keyboardFrame.top * renderScale;
+                double width = (keyboardFrame.right - keyboardFrame.left) * renderScale;
+                double height = (keyboardFrame.bottom - keyboardFrame.top) * renderScale;
                 platformData->display->keyboardVisibilityChangedFunc(platformData->display, keyboardVisible,
                                                                      x, y, width, height);
             }
@@ -2408,18 +3018,183 @@ double glfmGetTime(void) {
     return (double)(time.tv_sec - initTime) + (double)time.tv_nsec / 1e9;
 }
 
+static void glfm__invalidateDepthStencil(GLFMPlatformData *platformData) {
+    // Same values for GL_DEPTH/GL_STENCIL (OpenGL ES 3) and GL_DEPTH_EXT/GL_STENCIL_EXT (GL_EXT_discard_framebuffer)
+    static const GLenum GLFM_GL_DEPTH = 0x1801;
+    static const GLenum GLFM_GL_STENCIL = 0x1802;
+
+    GLFMDisplay *display = platformData->display;
+    if (!display || !display->depthStencilInvalidationEnabled || !platformData->eglContextCurrent) {
+        return;
+    }
+    GLenum attachments[2];
+    GLsizei numAttachments = 0;
+    if (display->depthFormat != GLFMDepthFormatNone) {
+        attachments[numAttachments++] = GLFM_GL_DEPTH;
+    }
+    if (display->stencilFormat != GLFMStencilFormatNone) {
+        attachments[numAttachments++] = GLFM_GL_STENCIL;
+    }
+    if (numAttachments == 0) {
+        return;
+    }
+
+    if (!platformData->invalidateFramebufferChecked) {
+        platformData->invalidateFramebufferChecked = true;
+        platformData->invalidateFramebuffer = NULL;
+        if (platformData->renderingAPI >= GLFMRenderingAPIOpenGLES3) {
+            platformData->invalidateFramebuffer =
+                (GLFMInvalidateFramebufferProc)glfmGetProcAddress("glInvalidateFramebuffer");
+        }
+        if (!platformData->invalidateFramebuffer) {
+            const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+            if (glfm__hasExtension(extensions, "GL_EXT_discard_framebuffer")) {
+                platformData->invalidateFramebuffer =
+                    (GLFMInvalidateFramebufferProc)glfmGetProcAddress("glDiscardFramebufferEXT");
+            }
+        }
+    }
+    if (platformData->invalidateFramebuffer) {
+        // The attachments are of the default framebuffer, which the app must have bound when swapping. The binding is
+        // not queried, since glGet can stall threaded drivers.
+        platformData->invalidateFramebuffer(GL_FRAMEBUFFER, numAttachments, attachments);
+    }
+}
+
+static void glfm__didSwapBuffers(GLFMPlatformData *platformData, EGLBoolean result) {
+    const double now = glfmGetTime();
+    const double frameDuration = now - platformData->lastSwapTime;
+    platformData->swapCalled = true;
+    platformData->lastSwapTime = now;
+    if (!result) {
+        glfm__eglCheckError(platformData);
+    } else if (platformData->refreshRate > 0 &&
+               glfm__updateAutomaticRenderScale(platformData->display, frameDuration,
+                                                1.0 / (double)platformData->refreshRate)) {
+        glfm__updateBuffersGeometry(platformData);
+    }
+}
+
 void glfmSwapBuffers(GLFMDisplay *display) {
     if (display) {
         GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+        glfm__invalidateDepthStencil(platformData);
         EGLBoolean result = eglSwapBuffers(platformData->eglDisplay, platformData->eglSurface);
-        platformData->swapCalled = true;
-        platformData->lastSwapTime = glfmGetTime();
-        if (!result) {
-            glfm__eglCheckError(platformData);
+        glfm__didSwapBuffers(platformData, result);
+    }
+}
+
+// Converts a rect with a top-left origin, in the app's coordinates, to an EGL rect (x, y, width, height) with a
+// bottom-left origin, in the coordinates of the surface's buffers. With a pre-transform, the buffers are rotated
+// relative to the app's coordinates (see glfm__getPreTransformMatrix).
+static void glfm__toEGLRect(GLFMSurfaceTransform preTransform, EGLint surfaceWidth, EGLint surfaceHeight,
+                            GLFMRect rect, EGLint *eglRect) {
+    switch (preTransform) {
+        case GLFMSurfaceTransformIdentity: default:
+            eglRect[0] = rect.x;
+            eglRect[1] = surfaceHeight - (rect.y + rect.height);
+            eglRect[2] = rect.width;
+            eglRect[3] = rect.height;
+            break;
+        case GLFMSurfaceTransformRotate90:
+            eglRect[0] = rect.y;
+            eglRect[1] = rect.x;
+            eglRect[2] = rect.height;
+            eglRect[3] = rect.width;
+            break;
+        case GLFMSurfaceTransformRotate180:
+            eglRect[0] = surfaceWidth - (rect.x + rect.width);
+            eglRect[1] = rect.y;
+            eglRect[2] = rect.width;
+            eglRect[3] = rect.height;
+            break;
+        case GLFMSurfaceTransformRotate270:
+            eglRect[0] = surfaceWidth - (rect.y + rect.height);
+            eglRect[1] = surfaceHeight - (rect.x + rect.width);
+            eglRect[2] = rect.height;
+            eglRect[3] = rect.width;
+            break;
+    }
+}
+
+// Converts rects with a top-left origin to EGL rects. If there are too many rects, they are merged into one.
+static EGLint glfm__toEGLRects(const GLFMPlatformData *platformData, const GLFMRect *rects, int count,
+                               EGLint eglRects[GLFM_MAX_DAMAGE_RECTS * 4]) {
+    // The surface size, not platformData->width and height, which are the (possibly not yet updated) logical size.
+    EGLint surfaceWidth = 0;
+    EGLint surfaceHeight = 0;
+    eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_WIDTH, &surfaceWidth);
+    eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_HEIGHT, &surfaceHeight);
+    if (count <= GLFM_MAX_DAMAGE_RECTS) {
+        for (int i = 0; i < count; i++) {
+            glfm__toEGLRect(platformData->preTransform, surfaceWidth, surfaceHeight, rects[i], eglRects + i * 4);
         }
+        return count;
+    } else {
+        int left = rects[0].x;
+        int top = rects[0].y;
+        int right = rects[0].x + rects[0].width;
+        int bottom = rects[0].y + rects[0].height;
+        for (int i = 1; i < count; i++) {
+            if (rects[i].x < left) left = rects[i].x;
+            if (rects[i].y < top) top = rects[i].y;
+            if (rects[i].x + rects[i].width > right) right = rects[i].x + rects[i].width;
+            if (rects[i].y + rects[i].height > bottom) bottom = rects[i].y + rects[i].height;
+        }
+        const GLFMRect bounds = { .x = left, .y = top, .width = right - left, .height = bottom - top };
+        glfm__toEGLRect(platformData->preTransform, surfaceWidth, surfaceHeight, bounds, eglRects);
+        return 1;
+    }
+}
+
+void glfmSwapBuffersWithDamage(GLFMDisplay *display, const GLFMRect *rects, int count) {
+    if (!display) {
+        return;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    GLFMEGLSwapBuffersWithDamageProc swapBuffersWithDamage = platformData->eglExtensions.swapBuffersWithDamage;
+    if (!rects || count <= 0 || !swapBuffersWithDamage) {
+        glfmSwapBuffers(display);
+        return;
+    }
+
+    EGLint eglRects[GLFM_MAX_DAMAGE_RECTS * 4];
+    EGLint numRects = glfm__toEGLRects(platformData, rects, count, eglRects);
+    glfm__invalidateDepthStencil(platformData);
+    EGLBoolean result = swapBuffersWithDamage(platformData->eglDisplay, platformData->eglSurface,
+                                              eglRects, numRects);
+    glfm__didSwapBuffers(platformData, result);
+}
+
+void glfmSetDamageRegion(GLFMDisplay *display, const GLFMRect *rects, int count) {
+    if (!display || !rects || count <= 0) {
+        return;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    GLFMEGLSetDamageRegionProc setDamageRegion = platformData->eglExtensions.setDamageRegion;
+    if (setDamageRegion && platformData->eglContextCurrent) {
+        EGLint eglRects[GLFM_MAX_DAMAGE_RECTS * 4];
+        EGLint numRects = glfm__toEGLRects(platformData, rects, count, eglRects);
+        setDamageRegion(platformData->eglDisplay, platformData->eglSurface, eglRects, numRects);
     }
 }
 
+int glfmGetBufferAge(GLFMDisplay *display) {
+    // Same value for EGL_BUFFER_AGE_EXT and EGL_BUFFER_AGE_KHR
+    static const EGLint EGL_BUFFER_AGE_EXT = 0x313D;
+
+    if (!display) {
+        return 0;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    EGLint age = 0;
+    if (platformData->eglExtensions.bufferAge && platformData->eglContextCurrent &&
+        !eglQuerySurface(platformData->eglDisplay, platformData->eglSurface, EGL_BUFFER_AGE_EXT, &age)) {
+        age = 0;
+    }
+    return age;
+}
+
 void glfmSetSupportedInterfaceOrientation(GLFMDisplay *display, GLFMInterfaceOrientation supportedOrientations) {
     if (display && display->supportedOrientations != supportedOrientations) {
         display->supportedOrientations = supportedOrientations;
@@ -2470,7 +3245,27 @@ void glfmGetDisplaySize(const GLFMDisplay *display, int *width, int *height) {
 
 double glfmGetDisplayScale(const GLFMDisplay *display) {
     GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
-    return platformData->scale;
+    return platformData->scale * platformData->renderScale;
+}
+
+GLFMSurfaceTransform glfmGetSurfaceTransformHint(const GLFMDisplay *display) {
+    if (!display) {
+        return GLFMSurfaceTransformIdentity;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    return glfm__getSurfaceTransformHint(platformData);
+}
+
+GLFMSurfaceTransform glfmGetPreTransform(const GLFMDisplay *display, float matrix[16]) {
+    GLFMSurfaceTransform transform = GLFMSurfaceTransformIdentity;
+    if (display) {
+        GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+        transform = platformData->preTransform;
+    }
+    if (matrix) {
+        glfm__getPreTransformMatrix(transform, matrix);
+    }
+    return transform;
 }
 
 void glfmGetDisplayChromeInsets(const GLFMDisplay *display, double *top, double *right,
@@ -2510,6 +3305,26 @@ bool glfmGetMultitouchEnabled(const GLFMDisplay *display) {
     return platformData->multitouchEnabled;
 }
 
+void glfmLatchInput(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    if (!platformData->rendering) {
+        return;
+    }
+    // Only the input and sensor queues are drained. Activity commands (lifecycle changes) wait until the frame ends.
+    platformData->rendering = false;
+    if (platformData->inputQueue && AInputQueue_hasEvents(platformData->inputQueue) > 0) {
+        glfm__onInputEvent(platformData);
+    }
+    if (platformData->sensorEventQueue) {
+        glfm__onSensorEvent(platformData);
+    }
+    glfm__flushCoalescedTouches(display);
+    platformData->rendering = true;
+}
+
 GLFMProc glfmGetProcAddress(const char *functionName) {
     GLFMProc function = eglGetProcAddress(functionName);
     if (!function) {
@@ -2540,10 +3355,83 @@ bool glfmIsKeyboardVisible(const GLFMDisplay *display) {
 }
 
 bool glfmIsSensorAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
-    (void)display;
+    if (sensor == GLFMSensorRotationMatrix && glfm__isSensorFusionAvailable(display)) {
+        return true;
+    }
     return glfm__getDeviceSensor(sensor) != NULL;
 }
 
+bool glfmIsSensorDirectChannelAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
+    if (!display) {
+        return false;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    return glfm__getDirectChannelSensor(platformData, sensor) != NULL;
+}
+
+bool glfmSetSensorDirectChannelEnabled(GLFMDisplay *display, GLFMSensor sensor, bool enabled) {
+    int index = (int)sensor;
+    if (!display || index < 0 || index >= GLFM_NUM_SENSORS) {
+        return false;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    GLFMSensorDirectChannel *channel = &platformData->sensorDirectChannels[index];
+    if (!enabled) {
+        glfm__destroySensorDirectChannel(platformData, index);
+        return false;
+    } else if (channel->channelId > 0) {
+        return true;
+    } else if (!glfm__getDirectChannelSensor(platformData, sensor)) {
+        return false;
+    } else {
+        return glfm__createSensorDirectChannel(platformData, index);
+    }
+}
+
+int glfmReadSensorDirectChannel(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorEvent *events, int maxEvents) {
+    int index = (int)sensor;
+    if (!display || !events || index < 0 || index >= GLFM_NUM_SENSORS) {
+        return 0;
+    }
+    GLFMPlatformData *platformData = (GLFMPlatformData *)display->platformData;
+    GLFMSensorDirectChannel *channel = &platformData->sensorDirectChannels[index];
+    if (!channel->events) {
+        return 0;
+    }
+
+    // The sensor service writes events sequentially into the ring, and sets each event's atomic counter (reserved0)
+    // last. The counter starts at 1 and skips 0 when it wraps.
+    int count = 0;
+    while (count < maxEvents) {
+        const ASensorEvent *slot = &channel->events[channel->readIndex];
+        const uint32_t *slotCounter = (const uint32_t *)&slot->reserved0;
+        uint32_t expectedCounter = channel->lastCounter + 1;
+        if (expectedCounter == 0) {
+            expectedCounter = 1;
+        }
+        uint32_t counter = __atomic_load_n(slotCounter, __ATOMIC_ACQUIRE);
+        if (counter == 0 || (int32_t)(counter - expectedCounter) < 0) {
+            // No new event
+            break;
+        }
+
+        // If the counter is ahead of the expected counter, the writer lapped the reader. Continue from this event.
+        ASensorEvent event;
+        memcpy(&event, slot, sizeof(ASensorEvent));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(slotCounter, __ATOMIC_RELAXED) != counter) {
+            // Overwritten while copying
+            continue;
+        }
+        channel->lastCounter = counter;
+        channel->readIndex = (channel->readIndex + 1) % GLFM_SENSOR_DIRECT_CHANNEL_EVENT_COUNT;
+        if (glfm__convertSensorEvent(platformData, &event, &events[count])) {
+            count++;
+        }
+    }
+    return count;
+}
+
 bool glfmIsHapticFeedbackSupported(const GLFMDisplay *display) {
     /*
     Vibrator vibrator = (Vibrator)context.getSystemService(Context.VIBRATOR_SERVICE);
@@ -337,9 +337,11 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         }
     }
 
+    glfm__createPendingResources(self.glfmDisplay);
     if (self.glfmDisplay->renderFunc) {
         self.glfmDisplay->renderFunc(self.glfmDisplay);
     }
+    glfm__clearEndedTouches(self.glfmDisplay);
 
     self.isDrawing = NO;
 }
@@ -807,10 +809,12 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
             self.glfmDisplay->surfaceRefreshFunc(self.glfmDisplay);
         }
     }
+    glfm__createPendingResources(self.glfmDisplay);
     if (self.glfmDisplay->renderFunc) {
         [self prepareRender];
         self.glfmDisplay->renderFunc(self.glfmDisplay);
     }
+    glfm__clearEndedTouches(self.glfmDisplay);
 
     self.isDrawing = NO;
 }
@@ -1097,9 +1101,11 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         }
     }
 
+    glfm__createPendingResources(self.glfmDisplay);
     if (self.glfmDisplay->renderFunc) {
         self.glfmDisplay->renderFunc(self.glfmDisplay);
     }
+    glfm__clearEndedTouches(self.glfmDisplay);
 
     self.isDrawing = NO;
 }
@@ -1312,9 +1318,14 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 }
 
 - (void)dealloc {
-    if (self.glfmViewIfLoaded.surfaceCreatedNotified && self.glfmDisplay->surfaceDestroyedFunc) {
-        self.glfmDisplay->surfaceDestroyedFunc(self.glfmDisplay);
+    if (self.glfmViewIfLoaded.surfaceCreatedNotified) {
+        // The view's context is destroyed with the view, which may outlive the display
+        glfm__invalidateResources(self.glfmDisplay);
+        if (self.glfmDisplay->surfaceDestroyedFunc) {
+            self.glfmDisplay->surfaceDestroyedFunc(self.glfmDisplay);
+        }
     }
+    glfm__freeDisplayData(self.glfmDisplay);
     free(self.glfmDisplay);
     self.glfmViewIfLoaded.preRenderCallback = nil;
 #if TARGET_OS_IOS
@@ -1437,6 +1448,7 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 #if TARGET_OS_IOS
     [self handleMotionEvents];
 #endif
+    glfm__flushCoalescedTouches(self.glfmDisplay);
 }
 
 - (void)viewDidLoad {
@@ -1586,40 +1598,62 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         return;
     }
     GLFMSensorFunc accelerometerFunc = self.glfmDisplay->sensorFuncs[GLFMSensorAccelerometer];
-    if (accelerometerFunc) {
+    GLFMSensorBatchFunc accelerometerBatchFunc = self.glfmDisplay->sensorBatchFuncs[GLFMSensorAccelerometer];
+    if (accelerometerFunc || accelerometerBatchFunc) {
         GLFMSensorEvent event = { 0 };
         event.sensor = GLFMSensorAccelerometer;
         event.timestamp = deviceMotion.timestamp;
         event.vector.x = deviceMotion.userAcceleration.x + deviceMotion.gravity.x;
         event.vector.y = deviceMotion.userAcceleration.y + deviceMotion.gravity.y;
         event.vector.z = deviceMotion.userAcceleration.z + deviceMotion.gravity.z;
-        accelerometerFunc(self.glfmDisplay, event);
+        glfm__addSensorHistory(self.glfmDisplay, &event);
+        if (accelerometerFunc) {
+            accelerometerFunc(self.glfmDisplay, event);
+        }
+        if (accelerometerBatchFunc) {
+            accelerometerBatchFunc(self.glfmDisplay, &event, 1);
+        }
     }
 
     GLFMSensorFunc magnetometerFunc = self.glfmDisplay->sensorFuncs[GLFMSensorMagnetometer];
-    if (magnetometerFunc) {
+    GLFMSensorBatchFunc magnetometerBatchFunc = self.glfmDisplay->sensorBatchFuncs[GLFMSensorMagnetometer];
+    if (magnetometerFunc || magnetometerBatchFunc) {
         GLFMSensorEvent event = { 0 };
         event.sensor = GLFMSensorMagnetometer;
         event.timestamp = deviceMotion.timestamp;
         event.vector.x = deviceMotion.magneticField.field.x;
         event.vector.y = deviceMotion.magneticField.field.y;
         event.vector.z = deviceMotion.magneticField.field.z;
-        magnetometerFunc(self.glfmDisplay, event);
+        glfm__addSensorHistory(self.glfmDisplay, &event);
+        if (magnetometerFunc) {
+            magnetometerFunc(self.glfmDisplay, event);
+        }
+        if (magnetometerBatchFunc) {
+            magnetometerBatchFunc(self.glfmDisplay, &event, 1);
+        }
     }
 
     GLFMSensorFunc gyroscopeFunc = self.glfmDisplay->sensorFuncs[GLFMSensorGyroscope];
-    if (gyroscopeFunc) {
+    GLFMSensorBatchFunc gyroscopeBatchFunc = self.glfmDisplay->sensorBatchFuncs[GLFMSensorGyroscope];
+    if (gyroscopeFunc || gyroscopeBatchFunc) {
         GLFMSensorEvent event = { 0 };
         event.sensor = GLFMSensorGyroscope;
         event.timestamp = deviceMotion.timestamp;
         event.vector.x = deviceMotion.rotationRate.x;
         event.vector.y = deviceMotion.rotationRate.y;
         event.vector.z = deviceMotion.rotationRate.z;
-        gyroscopeFunc(self.glfmDisplay, event);
+        glfm__addSensorHistory(self.glfmDisplay, &event);
+        if (gyroscopeFunc) {
+            gyroscopeFunc(self.glfmDisplay, event);
+        }
+        if (gyroscopeBatchFunc) {
+            gyroscopeBatchFunc(self.glfmDisplay, &event, 1);
+        }
     }
 
     GLFMSensorFunc rotationFunc = self.glfmDisplay->sensorFuncs[GLFMSensorRotationMatrix];
-    if (rotationFunc) {
+    GLFMSensorBatchFunc rotationBatchFunc = self.glfmDisplay->sensorBatchFuncs[GLFMSensorRotationMatrix];
+    if (rotationFunc || rotationBatchFunc) {
         GLFMSensorEvent event = { 0 };
         event.sensor = GLFMSensorRotationMatrix;
         event.timestamp = deviceMotion.timestamp;
@@ -1627,22 +1661,35 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         event.matrix.m00 = matrix.m11; event.matrix.m01 = matrix.m12; event.matrix.m02 = matrix.m13;
         event.matrix.m10 = matrix.m21; event.matrix.m11 = matrix.m22; event.matrix.m12 = matrix.m23;
         event.matrix.m20 = matrix.m31; event.matrix.m21 = matrix.m32; event.matrix.m22 = matrix.m33;
-        rotationFunc(self.glfmDisplay, event);
+        glfm__addSensorHistory(self.glfmDisplay, &event);
+        if (rotationFunc) {
+            rotationFunc(self.glfmDisplay, event);
+        }
+        if (rotationBatchFunc) {
+            rotationBatchFunc(self.glfmDisplay, &event, 1);
+        }
     }
 }
 
 - (void)updateMotionManagerActiveState {
     BOOL enable = NO;
+    double maxRate = 0.0;
     GLFMWindow *window = (GLFMWindow *)self.viewIfLoaded.window;
     if (window.active) {
         for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
-            if (self.glfmDisplay->sensorFuncs[i] != NULL) {
+            if (glfm__isSensorRequested(self.glfmDisplay, i)) {
                 enable = YES;
-                break;
+                double rate = self.glfmDisplay->sensorRates[i] > 0.0 ? self.glfmDisplay->sensorRates[i] : 100.0;
+                maxRate = MAX(maxRate, rate);
             }
         }
     }
 
+    if (enable) {
+        // All sensors share one update interval
+        self.motionManager.deviceMotionUpdateInterval = 1.0 / maxRate;
+    }
+
     if (enable && !self.motionManager.deviceMotionActive) {
         CMAttitudeReferenceFrame referenceFrame;
         CMAttitudeReferenceFrame availableReferenceFrames = [CMMotionManager availableAttitudeReferenceFrames];
@@ -1657,6 +1704,11 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
     } else if (!enable && self.isMotionManagerLoaded && self.motionManager.deviceMotionActive) {
         [self.motionManager stopDeviceMotionUpdates];
     }
+    for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+        if (!enable || !glfm__isSensorRequested(self.glfmDisplay, i)) {
+            glfm__clearSensorHistory(self.glfmDisplay, i);
+        }
+    }
 }
 
 #endif // TARGET_OS_IOS
@@ -1696,13 +1748,13 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         activeTouches[index] = (__bridge const void *)touch;
     }
 
-    if (self.glfmDisplay->touchFunc) {
-        CGPoint currLocation = [touch locationInView:self.view];
-        currLocation.x *= self.view.contentScaleFactor;
-        currLocation.y *= self.view.contentScaleFactor;
+    CGPoint currLocation = [touch locationInView:self.view];
+    currLocation.x *= self.view.contentScaleFactor;
+    currLocation.y *= self.view.contentScaleFactor;
 
-        self.glfmDisplay->touchFunc(self.glfmDisplay, index, phase, (double)currLocation.x, (double)currLocation.y);
-    }
+    // UITouch timestamps and CACurrentMediaTime() both use mach_absolute_time()
+    glfm__sendTouchEvent(self.glfmDisplay, index, phase, (double)currLocation.x, (double)currLocation.y,
+                         touch.timestamp);
 
     if (phase == GLFMTouchPhaseEnded || phase == GLFMTouchPhaseCancelled) {
         activeTouches[index] = NULL;
@@ -1736,14 +1788,16 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 #if TARGET_OS_IOS
 
 - (void)hover:(UIHoverGestureRecognizer *)recognizer API_AVAILABLE(ios(13.4)) {
-    if (self.glfmDisplay->touchFunc && (recognizer.state == UIGestureRecognizerStateBegan ||
-                                        recognizer.state == UIGestureRecognizerStateChanged)) {
+    if (recognizer.state == UIGestureRecognizerStateBegan || recognizer.state == UIGestureRecognizerStateChanged) {
         CGPoint currLocation = [recognizer locationInView:self.view];
         currLocation.x *= self.view.contentScaleFactor;
         currLocation.y *= self.view.contentScaleFactor;
 
-        self.glfmDisplay->touchFunc(self.glfmDisplay, 0, GLFMTouchPhaseHover,
-                                    (double)currLocation.x, (double)currLocation.y);
+        glfm__sendTouchEvent(self.glfmDisplay, 0, GLFMTouchPhaseHover,
+                             (double)currLocation.x, (double)currLocation.y, glfmGetTime());
+    } else if (recognizer.state == UIGestureRecognizerStateEnded ||
+               recognizer.state == UIGestureRecognizerStateCancelled) {
+        glfm__cancelHover(self.glfmDisplay, 0, glfmGetTime());
     }
 }
 
@@ -1770,16 +1824,6 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 #endif
 
 - (BOOL)handlePress:(UIPress *)press withAction:(GLFMKeyAction)action {
-#if TARGET_OS_IOS
-    if (!self.glfmDisplay->keyFunc) {
-        return NO;
-    }
-#elif TARGET_OS_TV
-    if (!self.glfmDisplay->keyFunc && !self.glfmDisplay->charFunc) {
-        return NO;
-    }
-#endif
-
     GLFMKeyCode keyCode = GLFMKeyCodeUnknown;
     int modifierFlags = 0;
     BOOL hasKey = NO;
@@ -1959,7 +2003,7 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         // The tab key on the Magic Keyboard sends two UIPress events. For the second one, press.key=nil and press.type=0xcb.
         return NO;
     }
-    BOOL handled = self.glfmDisplay->keyFunc(self.glfmDisplay, keyCode, action, modifierFlags);
+    BOOL handled = glfm__sendKeyEvent(self.glfmDisplay, keyCode, action, modifierFlags);
     if (self.isFirstResponder && isPrintable && self.glfmDisplay->charFunc) {
         // Send text via insertText.
         return NO;
@@ -2011,10 +2055,7 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         }
     }
 
-    BOOL handled = NO;
-    if (self.glfmDisplay->keyFunc) {
-        handled = self.glfmDisplay->keyFunc(self.glfmDisplay, keyCode, action, modifierFlags);
-    }
+    BOOL handled = glfm__sendKeyEvent(self.glfmDisplay, keyCode, action, modifierFlags);
     if (@available(iOS 13.4, tvOS 13.4, *)) {
         if (self.isFirstResponder && hasKey && isPrintable && self.glfmDisplay->charFunc) {
             self.glfmDisplay->charFunc(self.glfmDisplay, press.key.characters.UTF8String, 0);
@@ -2121,19 +2162,11 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 
 - (void)insertText:(NSString *)text {
     if ([text isEqualToString:@"\n"]) {
-        if (self.glfmDisplay->keyFunc) {
-            self.glfmDisplay->keyFunc(self.glfmDisplay, GLFMKeyCodeEnter, GLFMKeyActionPressed, 0);
-        }
-        if (self.glfmDisplay->keyFunc) {
-            self.glfmDisplay->keyFunc(self.glfmDisplay, GLFMKeyCodeEnter, GLFMKeyActionReleased, 0);
-        }
+        glfm__sendKeyEvent(self.glfmDisplay, GLFMKeyCodeEnter, GLFMKeyActionPressed, 0);
+        glfm__sendKeyEvent(self.glfmDisplay, GLFMKeyCodeEnter, GLFMKeyActionReleased, 0);
     } else if ([text isEqualToString:@"\t"]) {
-        if (self.glfmDisplay->keyFunc) {
-            self.glfmDisplay->keyFunc(self.glfmDisplay, GLFMKeyCodeTab, GLFMKeyActionPressed, 0);
-        }
-        if (self.glfmDisplay->keyFunc) {
-            self.glfmDisplay->keyFunc(self.glfmDisplay, GLFMKeyCodeTab, GLFMKeyActionReleased, 0);
-        }
+        glfm__sendKeyEvent(self.glfmDisplay, GLFMKeyCodeTab, GLFMKeyActionPressed, 0);
+        glfm__sendKeyEvent(self.glfmDisplay, GLFMKeyCodeTab, GLFMKeyActionReleased, 0);
     } else if (self.glfmDisplay->charFunc) {
         self.glfmDisplay->charFunc(self.glfmDisplay, text.UTF8String, 0);
     }
@@ -2142,12 +2175,8 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 - (void)deleteBackward {
     // NOTE: This method is called for key repeat events when using a hardware keyboard, but not
     // when using the software keyboard.
-    if (self.glfmDisplay->keyFunc) {
-        self.glfmDisplay->keyFunc(self.glfmDisplay, GLFMKeyCodeBackspace, GLFMKeyActionPressed, 0);
-    }
-    if (self.glfmDisplay->keyFunc) {
-        self.glfmDisplay->keyFunc(self.glfmDisplay, GLFMKeyCodeBackspace, GLFMKeyActionReleased, 0);
-    }
+    glfm__sendKeyEvent(self.glfmDisplay, GLFMKeyCodeBackspace, GLFMKeyActionPressed, 0);
+    glfm__sendKeyEvent(self.glfmDisplay, GLFMKeyCodeBackspace, GLFMKeyActionReleased, 0);
 }
 
 #endif // TARGET_OS_IOS
@@ -2195,12 +2224,8 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
     } else if (key == UIKeyInputPageDown) {
         keyCode = GLFMKeyCodePageDown;
     }
-    if (self.glfmDisplay->keyFunc) {
-        self.glfmDisplay->keyFunc(self.glfmDisplay, keyCode, GLFMKeyActionPressed, 0);
-    }
-    if (self.glfmDisplay->keyFunc) {
-        self.glfmDisplay->keyFunc(self.glfmDisplay, keyCode, GLFMKeyActionReleased, 0);
-    }
+    glfm__sendKeyEvent(self.glfmDisplay, keyCode, GLFMKeyActionPressed, 0);
+    glfm__sendKeyEvent(self.glfmDisplay, keyCode, GLFMKeyActionReleased, 0);
 }
 
 #endif // TARGET_OS_IOS || TARGET_OS_TV
@@ -2234,10 +2259,6 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 }
 
 - (void)sendMouseEvent:(NSEvent *)event withType:(GLFMTouchPhase)phase {
-    if (!self.glfmDisplay->touchFunc) {
-        return;
-    }
-
     double x, y;
     if (![self getLocationForEvent:event outX:&x outY:&y]) {
         return;
@@ -2250,7 +2271,8 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         }
     }
 
-    self.glfmDisplay->touchFunc(self.glfmDisplay, (int)event.buttonNumber, phase, x, y);
+    // NSEvent timestamps and CACurrentMediaTime() both use mach_absolute_time()
+    glfm__sendTouchEvent(self.glfmDisplay, (int)event.buttonNumber, phase, x, y, event.timestamp);
 }
 
 - (void)mouseMoved:(NSEvent *)event {
@@ -2327,6 +2349,9 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
 - (void)mouseExited:(NSEvent *)event {
     self.mouseInside = NO;
     [NSCursor.arrowCursor set];
+
+    // Hover events use the left mouse button's touch number. A drag continues outside the view.
+    glfm__cancelHover(self.glfmDisplay, 0, event.timestamp);
 }
 
 // MARK: NSResponder (Keyboard)
@@ -2352,145 +2377,143 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
     BOOL handled = NO;
 
     // Send key event
-    if (self.glfmDisplay->keyFunc) {
-        static const GLFMKeyCode VK_MAP[] = {
-            [kVK_Return]                    = GLFMKeyCodeEnter,
-            [kVK_Tab]                       = GLFMKeyCodeTab,
-            [kVK_Space]                     = GLFMKeyCodeSpace,
-            [kVK_Delete]                    = GLFMKeyCodeBackspace,
-            [kVK_Escape]                    = GLFMKeyCodeEscape,
-            [kVK_Command]                   = GLFMKeyCodeMetaLeft,
-            [kVK_Shift]                     = GLFMKeyCodeShiftLeft,
-            [kVK_CapsLock]                  = GLFMKeyCodeCapsLock,
-            [kVK_Option]                    = GLFMKeyCodeAltLeft,
-            [kVK_Control]                   = GLFMKeyCodeControlLeft,
-            [kVK_RightCommand]              = GLFMKeyCodeMetaRight,
-            [kVK_RightShift]                = GLFMKeyCodeShiftRight,
-            [kVK_RightOption]               = GLFMKeyCodeAltRight,
-            [kVK_RightControl]              = GLFMKeyCodeControlRight,
-            [kVK_Function]                  = GLFMKeyCodeFunction,
-            [kVK_Help]                      = GLFMKeyCodeInsert,
-            [kVK_Home]                      = GLFMKeyCodeHome,
-            [kVK_PageUp]                    = GLFMKeyCodePageUp,
-            [kVK_ForwardDelete]             = GLFMKeyCodeDelete,
-            [kVK_End]                       = GLFMKeyCodeEnd,
-            [kVK_PageDown]                  = GLFMKeyCodePageDown,
-            [kVK_LeftArrow]                 = GLFMKeyCodeArrowLeft,
-            [kVK_RightArrow]                = GLFMKeyCodeArrowRight,
-            [kVK_DownArrow]                 = GLFMKeyCodeArrowDown,
-            [kVK_UpArrow]                   = GLFMKeyCodeArrowUp,
-            [kVK_ANSI_A]                    = GLFMKeyCodeA,
-            [kVK_ANSI_B]                    = GLFMKeyCodeB,
-            [kVK_ANSI_C]                    = GLFMKeyCodeC,
-            [kVK_ANSI_D]                    = GLFMKeyCodeD,
-            [kVK_ANSI_E]                    = GLFMKeyCodeE,
-            [kVK_ANSI_F]                    = GLFMKeyCodeF,
-            [kVK_ANSI_G]                    = GLFMKeyCodeG,
-            [kVK_ANSI_H]                    = GLFMKeyCodeH,
-            [kVK_ANSI_I]                    = GLFMKeyCodeI,
-            [kVK_ANSI_J]                    = GLFMKeyCodeJ,
-            [kVK_ANSI_K]                    = GLFMKeyCodeK,
-            [kVK_ANSI_L]                    = GLFMKeyCodeL,
-            [kVK_ANSI_N]                    = GLFMKeyCodeN,
-            [kVK_ANSI_M]                    = GLFMKeyCodeM,
-            [kVK_ANSI_O]                    = GLFMKeyCodeO,
-            [kVK_ANSI_P]                    = GLFMKeyCodeP,
-            [kVK_ANSI_Q]                    = GLFMKeyCodeQ,
-            [kVK_ANSI_R]                    = GLFMKeyCodeR,
-            [kVK_ANSI_S]                    = GLFMKeyCodeS,
-            [kVK_ANSI_T]                    = GLFMKeyCodeT,
-            [kVK_ANSI_U]                    = GLFMKeyCodeU,
-            [kVK_ANSI_V]                    = GLFMKeyCodeV,
-            [kVK_ANSI_W]                    = GLFMKeyCodeW,
-            [kVK_ANSI_X]                    = GLFMKeyCodeX,
-            [kVK_ANSI_Y]                    = GLFMKeyCodeY,
-            [kVK_ANSI_Z]                    = GLFMKeyCodeZ,
-            [kVK_ANSI_0]                    = GLFMKeyCode0,
-            [kVK_ANSI_1]                    = GLFMKeyCode1,
-            [kVK_ANSI_2]                    = GLFMKeyCode2,
-            [kVK_ANSI_3]                    = GLFMKeyCode3,
-            [kVK_ANSI_4]                    = GLFMKeyCode4,
-            [kVK_ANSI_5]                    = GLFMKeyCode5,
-            [kVK_ANSI_6]                    = GLFMKeyCode6,
-            [kVK_ANSI_7]                    = GLFMKeyCode7,
-            [kVK_ANSI_8]                    = GLFMKeyCode8,
-            [kVK_ANSI_9]                    = GLFMKeyCode9,
-            [kVK_ANSI_Equal]                = GLFMKeyCodeEqual,
-            [kVK_ANSI_Minus]                = GLFMKeyCodeMinus,
-            [kVK_ANSI_RightBracket]         = GLFMKeyCodeBracketRight,
-            [kVK_ANSI_LeftBracket]          = GLFMKeyCodeBracketLeft,
-            [kVK_ANSI_Quote]                = GLFMKeyCodeQuote,
-            [kVK_ANSI_Semicolon]            = GLFMKeyCodeSemicolon,
-            [kVK_ANSI_Backslash]            = GLFMKeyCodeBackslash,
-            [kVK_ANSI_Comma]                = GLFMKeyCodeComma,
-            [kVK_ANSI_Slash]                = GLFMKeyCodeSlash,
-            [kVK_ANSI_Period]               = GLFMKeyCodePeriod,
-            [kVK_ANSI_Grave]                = GLFMKeyCodeBackquote,
-            [kVK_ANSI_KeypadClear]          = GLFMKeyCodeNumLock,
-            [kVK_ANSI_KeypadDecimal]        = GLFMKeyCodeNumpadDecimal,
-            [kVK_ANSI_KeypadMultiply]       = GLFMKeyCodeNumpadMultiply,
-            [kVK_ANSI_KeypadPlus]           = GLFMKeyCodeNumpadAdd,
-            [kVK_ANSI_KeypadDivide]         = GLFMKeyCodeNumpadDivide,
-            [kVK_ANSI_KeypadEnter]          = GLFMKeyCodeNumpadEnter,
-            [kVK_ANSI_KeypadMinus]          = GLFMKeyCodeNumpadSubtract,
-            [kVK_ANSI_KeypadEquals]         = GLFMKeyCodeNumpadEqual,
-            [kVK_ANSI_Keypad0]              = GLFMKeyCodeNumpad0,
-            [kVK_ANSI_Keypad1]              = GLFMKeyCodeNumpad1,
-            [kVK_ANSI_Keypad2]              = GLFMKeyCodeNumpad2,
-            [kVK_ANSI_Keypad3]              = GLFMKeyCodeNumpad3,
-            [kVK_ANSI_Keypad4]              = GLFMKeyCodeNumpad4,
-            [kVK_ANSI_Keypad5]              = GLFMKeyCodeNumpad5,
-            [kVK_ANSI_Keypad6]              = GLFMKeyCodeNumpad6,
-            [kVK_ANSI_Keypad7]              = GLFMKeyCodeNumpad7,
-            [kVK_ANSI_Keypad8]              = GLFMKeyCodeNumpad8,
-            [kVK_ANSI_Keypad9]              = GLFMKeyCodeNumpad9,
-            [kVK_F1]                        = GLFMKeyCodeF1,
-            [kVK_F2]                        = GLFMKeyCodeF2,
-            [kVK_F3]                        = GLFMKeyCodeF3,
-            [kVK_F4]                        = GLFMKeyCodeF4,
-            [kVK_F5]                        = GLFMKeyCodeF5,
-            [kVK_F6]                        = GLFMKeyCodeF6,
-            [kVK_F7]                        = GLFMKeyCodeF7,
-            [kVK_F8]                        = GLFMKeyCodeF8,
-            [kVK_F9]                        = GLFMKeyCodeF9,
-            [kVK_F10]                       = GLFMKeyCodeF10,
-            [kVK_F11]                       = GLFMKeyCodeF11,
-            [kVK_F12]                       = GLFMKeyCodeF12,
-            [kVK_F13]                       = GLFMKeyCodeF13,
-            [kVK_F14]                       = GLFMKeyCodeF14,
-            [kVK_F15]                       = GLFMKeyCodeF15,
-            [kVK_F16]                       = GLFMKeyCodeF16,
-            [kVK_F17]                       = GLFMKeyCodeF17,
-            [kVK_F18]                       = GLFMKeyCodeF18,
-            [kVK_F19]                       = GLFMKeyCodeF19,
-            [kVK_F20]                       = GLFMKeyCodeF20,
-            [0x6e]                          = GLFMKeyCodeMenu,
-        };
-
-        GLFMKeyCode keyCode = GLFMKeyCodeUnknown;
-        if (event.keyCode < sizeof(VK_MAP) / sizeof(*VK_MAP)) {
-            keyCode = VK_MAP[event.keyCode];
-        }
+    static const GLFMKeyCode VK_MAP[] = {
+        [kVK_Return]                    = GLFMKeyCodeEnter,
+        [kVK_Tab]                       = GLFMKeyCodeTab,
+        [kVK_Space]                     = GLFMKeyCodeSpace,
+        [kVK_Delete]                    = GLFMKeyCodeBackspace,
+        [kVK_Escape]                    = GLFMKeyCodeEscape,
+        [kVK_Command]                   = GLFMKeyCodeMetaLeft,
+        [kVK_Shift]                     = GLFMKeyCodeShiftLeft,
+        [kVK_CapsLock]                  = GLFMKeyCodeCapsLock,
+        [kVK_Option]                    = GLFMKeyCodeAltLeft,
+        [kVK_Control]                   = GLFMKeyCodeControlLeft,
+        [kVK_RightCommand]              = GLFMKeyCodeMetaRight,
+        [kVK_RightShift]                = GLFMKeyCodeShiftRight,
+        [kVK_RightOption]               = GLFMKeyCodeAltRight,
+        [kVK_RightControl]              = GLFMKeyCodeControlRight,
+        [kVK_Function]                  = GLFMKeyCodeFunction,
+        [kVK_Help]                      = GLFMKeyCodeInsert,
+        [kVK_Home]                      = GLFMKeyCodeHome,
+        [kVK_PageUp]                    = GLFMKeyCodePageUp,
+        [kVK_ForwardDelete]             = GLFMKeyCodeDelete,
+        [kVK_End]                       = GLFMKeyCodeEnd,
+        [kVK_PageDown]                  = GLFMKeyCodePageDown,
+        [kVK_LeftArrow]                 = GLFMKeyCodeArrowLeft,
+        [kVK_RightArrow]                = GLFMKeyCodeArrowRight,
+        [kVK_DownArrow]                 = GLFMKeyCodeArrowDown,
+        [kVK_UpArrow]                   = GLFMKeyCodeArrowUp,
+        [kVK_ANSI_A]                    = GLFMKeyCodeA,
+        [kVK_ANSI_B]                    = GLFMKeyCodeB,
+        [kVK_ANSI_C]                    = GLFMKeyCodeC,
+        [kVK_ANSI_D]                    = GLFMKeyCodeD,
+        [kVK_ANSI_E]                    = GLFMKeyCodeE,
+        [kVK_ANSI_F]                    = GLFMKeyCodeF,
+        [kVK_ANSI_G]                    = GLFMKeyCodeG,
+        [kVK_ANSI_H]                    = GLFMKeyCodeH,
+        [kVK_ANSI_I]                    = GLFMKeyCodeI,
+        [kVK_ANSI_J]                    = GLFMKeyCodeJ,
+        [kVK_ANSI_K]                    = GLFMKeyCodeK,
+        [kVK_ANSI_L]                    = GLFMKeyCodeL,
+        [kVK_ANSI_N]                    = GLFMKeyCodeN,
+        [kVK_ANSI_M]                    = GLFMKeyCodeM,
+        [kVK_ANSI_O]                    = GLFMKeyCodeO,
+        [kVK_ANSI_P]                    = GLFMKeyCodeP,
+        [kVK_ANSI_Q]                    = GLFMKeyCodeQ,
+        [kVK_ANSI_R]                    = GLFMKeyCodeR,
+        [kVK_ANSI_S]                    = GLFMKeyCodeS,
+        [kVK_ANSI_T]                    = GLFMKeyCodeT,
+        [kVK_ANSI_U]                    = GLFMKeyCodeU,
+        [kVK_ANSI_V]                    = GLFMKeyCodeV,
+        [kVK_ANSI_W]                    = GLFMKeyCodeW,
+        [kVK_ANSI_X]                    = GLFMKeyCodeX,
+        [kVK_ANSI_Y]                    = GLFMKeyCodeY,
+        [kVK_ANSI_Z]                    = GLFMKeyCodeZ,
+        [kVK_ANSI_0]                    = GLFMKeyCode0,
+        [kVK_ANSI_1]                    = GLFMKeyCode1,
+        [kVK_ANSI_2]                    = GLFMKeyCode2,
+        [kVK_ANSI_3]                    = GLFMKeyCode3,
+        [kVK_ANSI_4]                    = GLFMKeyCode4,
+        [kVK_ANSI_5]                    = GLFMKeyCode5,
+        [kVK_ANSI_6]                    = GLFMKeyCode6,
+        [kVK_ANSI_7]                    = GLFMKeyCode7,
+        [kVK_ANSI_8]                    = GLFMKeyCode8,
+        [kVK_ANSI_9]                    = GLFMKeyCode9,
+        [kVK_ANSI_Equal]                = GLFMKeyCodeEqual,
+        [kVK_ANSI_Minus]                = GLFMKeyCodeMinus,
+        [kVK_ANSI_RightBracket]         = GLFMKeyCodeBracketRight,
+        [kVK_ANSI_LeftBracket]          = GLFMKeyCodeBracketLeft,
+        [kVK_ANSI_Quote]                = GLFMKeyCodeQuote,
+        [kVK_ANSI_Semicolon]            = GLFMKeyCodeSemicolon,
+        [kVK_ANSI_Backslash]            = GLFMKeyCodeBackslash,
+        [kVK_ANSI_Comma]                = GLFMKeyCodeComma,
+        [kVK_ANSI_Slash]                = GLFMKeyCodeSlash,
+        [kVK_ANSI_Period]               = GLFMKeyCodePeriod,
+        [kVK_ANSI_Grave]                = GLFMKeyCodeBackquote,
+        [kVK_ANSI_KeypadClear]          = GLFMKeyCodeNumLock,
+        [kVK_ANSI_KeypadDecimal]        = GLFMKeyCodeNumpadDecimal,
+        [kVK_ANSI_KeypadMultiply]       = GLFMKeyCodeNumpadMultiply,
+        [kVK_ANSI_KeypadPlus]           = GLFMKeyCodeNumpadAdd,
+        [kVK_ANSI_KeypadDivide]         = GLFMKeyCodeNumpadDivide,
+        [kVK_ANSI_KeypadEnter]          = GLFMKeyCodeNumpadEnter,
+        [kVK_ANSI_KeypadMinus]          = GLFMKeyCodeNumpadSubtract,
+        [kVK_ANSI_KeypadEquals]         = GLFMKeyCodeNumpadEqual,
+        [kVK_ANSI_Keypad0]              = GLFMKeyCodeNumpad0,
+        [kVK_ANSI_Keypad1]              = GLFMKeyCodeNumpad1,
+        [kVK_ANSI_Keypad2]              = GLFMKeyCodeNumpad2,
+        [kVK_ANSI_Keypad3]              = GLFMKeyCodeNumpad3,
+        [kVK_ANSI_Keypad4]              = GLFMKeyCodeNumpad4,
+        [kVK_ANSI_Keypad5]              = GLFMKeyCodeNumpad5,
+        [kVK_ANSI_Keypad6]              = GLFMKeyCodeNumpad6,
+        [kVK_ANSI_Keypad7]              = GLFMKeyCodeNumpad7,
+        [kVK_ANSI_Keypad8]              = GLFMKeyCodeNumpad8,
+        [kVK_ANSI_Keypad9]              = GLFMKeyCodeNumpad9,
+        [kVK_F1]                        = GLFMKeyCodeF1,
+        [kVK_F2]                        = GLFMKeyCodeF2,
+        [kVK_F3]                        = GLFMKeyCodeF3,
+        [kVK_F4]                        = GLFMKeyCodeF4,
+        [kVK_F5]                        = GLFMKeyCodeF5,
+        [kVK_F6]                        = GLFMKeyCodeF6,
+        [kVK_F7]                        = GLFMKeyCodeF7,
+        [kVK_F8]                        = GLFMKeyCodeF8,
+        [kVK_F9]                        = GLFMKeyCodeF9,
+        [kVK_F10]                       = GLFMKeyCodeF10,
+        [kVK_F11]                       = GLFMKeyCodeF11,
+        [kVK_F12]                       = GLFMKeyCodeF12,
+        [kVK_F13]                       = GLFMKeyCodeF13,
+        [kVK_F14]                       = GLFMKeyCodeF14,
+        [kVK_F15]                       = GLFMKeyCodeF15,
+        [kVK_F16]                       = GLFMKeyCodeF16,
+        [kVK_F17]                       = GLFMKeyCodeF17,
+        [kVK_F18]                       = GLFMKeyCodeF18,
+        [kVK_F19]                       = GLFMKeyCodeF19,
+        [kVK_F20]                       = GLFMKeyCodeF20,
+        [0x6e]                          = GLFMKeyCodeMenu,
+    };
 
-        int modifiers = 0;
-        if ((event.modifierFlags & NSEventModifierFlagShift) != 0) {
-            modifiers |= GLFMKeyModifierShift;
-        }
-        if ((event.modifierFlags & NSEventModifierFlagControl) != 0) {
-            modifiers |= GLFMKeyModifierControl;
-        }
-        if ((event.modifierFlags & NSEventModifierFlagOption) != 0) {
-            modifiers |= GLFMKeyModifierAlt;
-        }
-        if ((event.modifierFlags & NSEventModifierFlagCommand) != 0) {
-            modifiers |= GLFMKeyModifierMeta;
-        }
-        if (self.fnModifier) {
-            modifiers |= GLFMKeyModifierFunction;
-        }
+    GLFMKeyCode keyCode = GLFMKeyCodeUnknown;
+    if (event.keyCode < sizeof(VK_MAP) / sizeof(*VK_MAP)) {
+        keyCode = VK_MAP[event.keyCode];
+    }
 
-        handled = self.glfmDisplay->keyFunc(self.glfmDisplay, keyCode, action, modifiers);
+    int modifiers = 0;
+    if ((event.modifierFlags & NSEventModifierFlagShift) != 0) {
+        modifiers |= GLFMKeyModifierShift;
+    }
+    if ((event.modifierFlags & NSEventModifierFlagControl) != 0) {
+        modifiers |= GLFMKeyModifierControl;
+    }
+    if ((event.modifierFlags & NSEventModifierFlagOption) != 0) {
+        modifiers |= GLFMKeyModifierAlt;
     }
+    if ((event.modifierFlags & NSEventModifierFlagCommand) != 0) {
+        modifiers |= GLFMKeyModifierMeta;
+    }
+    if (self.fnModifier) {
+        modifiers |= GLFMKeyModifierFunction;
+    }
+
+    handled = glfm__sendKeyEvent(self.glfmDisplay, keyCode, action, modifiers);
 
     // Send char event
     if (self.glfmDisplay->charFunc &&
@@ -2609,6 +2632,9 @@ static void glfm__getDrawableSize(double displayWidth, double displayHeight, dou
         if (viewController.glfmDisplay && viewController.glfmDisplay->focusFunc) {
             viewController.glfmDisplay->focusFunc(viewController.glfmDisplay, _active);
         }
+        if (!active) {
+            glfm__clearKeysDown(viewController.glfmDisplay);
+        }
         if (viewController.isViewLoaded) {
             if (!active) {
                 // Draw once when entering the background so that a game can show "paused" state.
@@ -3144,6 +3170,39 @@ static void glfm__sensorFuncUpdated(GLFMDisplay *display) {
 #endif
 }
 
+static void glfm__inputFuncUpdated(GLFMDisplay *display) {
+    (void)display;
+}
+
+static void glfm__hiddenFrameRateUpdated(GLFMDisplay *display) {
+    (void)display;
+}
+
+static char *glfm__copySupportedExtensions(GLFMDisplay *display) {
+    (void)display;
+#if TARGET_OS_IOS || TARGET_OS_TV
+    if (![EAGLContext currentContext]) {
+        return NULL;
+    }
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+    if (!extensions) {
+        return NULL;
+    }
+    char *copy = malloc(strlen(extensions) + 1);
+    if (copy) {
+        strcpy(copy, extensions);
+    }
+    return copy;
+#else
+    return NULL;
+#endif
+}
+
+static double glfm__getSensorTimestamp(double time) {
+    // CMDeviceMotion timestamps and CACurrentMediaTime() both use mach_absolute_time()
+    return time;
+}
+
 // MARK: - GLFM public functions
 
 double glfmGetTime(void) {
@@ -3165,6 +3224,23 @@ void glfmSwapBuffers(GLFMDisplay *display) {
     }
 }
 
+void glfmSwapBuffersWithDamage(GLFMDisplay *display, const GLFMRect *rects, int count) {
+    (void)rects;
+    (void)count;
+    glfmSwapBuffers(display);
+}
+
+void glfmSetDamageRegion(GLFMDisplay *display, const GLFMRect *rects, int count) {
+    (void)display;
+    (void)rects;
+    (void)count;
+}
+
+int glfmGetBufferAge(GLFMDisplay *display) {
+    (void)display;
+    return 0;
+}
+
 void glfmSetSupportedInterfaceOrientation(GLFMDisplay *display, GLFMInterfaceOrientation supportedOrientations) {
     if (display) {
         if (display->supportedOrientations != supportedOrientations) {
@@ -3239,6 +3315,19 @@ double glfmGetDisplayScale(const GLFMDisplay *display) {
 #endif
 }
 
+GLFMSurfaceTransform glfmGetSurfaceTransformHint(const GLFMDisplay *display) {
+    (void)display;
+    return GLFMSurfaceTransformIdentity;
+}
+
+GLFMSurfaceTransform glfmGetPreTransform(const GLFMDisplay *display, float matrix[16]) {
+    (void)display;
+    if (matrix) {
+        glfm__getPreTransformMatrix(GLFMSurfaceTransformIdentity, matrix);
+    }
+    return GLFMSurfaceTransformIdentity;
+}
+
 void glfmGetDisplayChromeInsets(const GLFMDisplay *display, double *top, double *right,
                                 double *bottom, double *left) {
     if (display && display->platformData) {
@@ -3376,6 +3465,11 @@ void glfmSetMouseCursor(GLFMDisplay *display, GLFMMouseCursor mouseCursor) {
 #endif
 }
 
+void glfmLatchInput(GLFMDisplay *display) {
+    // Events are dispatched on the main thread between frames, so only held touch moves are pending.
+    glfm__flushCoalescedTouches(display);
+}
+
 void glfmSetMultitouchEnabled(GLFMDisplay *display, bool multitouchEnabled) {
 #if TARGET_OS_IOS
     if (display) {
@@ -3468,6 +3562,27 @@ bool glfmIsSensorAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
 #endif
 }
 
+bool glfmIsSensorDirectChannelAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
+    (void)display;
+    (void)sensor;
+    return false;
+}
+
+bool glfmSetSensorDirectChannelEnabled(GLFMDisplay *display, GLFMSensor sensor, bool enabled) {
+    (void)display;
+    (void)sensor;
+    (void)enabled;
+    return false;
+}
+
+int glfmReadSensorDirectChannel(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorEvent *events, int maxEvents) {
+    (void)display;
+    (void)sensor;
+    (void)events;
+    (void)maxEvents;
+    return 0;
+}
+
 bool glfmIsHapticFeedbackSupported(const GLFMDisplay *display) {
     (void)display;
 #if TARGET_OS_IOS
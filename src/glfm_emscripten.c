@@ -9,11 +9,32 @@
 #include <emscripten/emscripten.h>
 #include <emscripten/html5.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
 
+// If 1, glfmMain and the main loop run on a worker thread that renders to an OffscreenCanvas, and the browser's main
+// thread only runs the DOM event listeners. Requires compiling and linking with `-pthread`, and linking with
+// `-sOFFSCREENCANVAS_SUPPORT`. See the GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS option in CMakeLists.txt.
+#ifndef GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+#  define GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS 0
+#endif
+
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+#  if !defined(__EMSCRIPTEN_PTHREADS__)
+#    error GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS requires compiling with -pthread
+#  endif
+#  include <emscripten/proxying.h>
+#  include <emscripten/threading.h>
+#  include <pthread.h>
+#endif
+
 #include "glfm_internal.h"
+#if GLFM_FEATURE_KEYBOARD
+#  include "glfm_keyboard_tables.h"
+#endif
 
 #ifdef NDEBUG
 #  define GLFM_LOG(...) do { } while (0)
@@ -22,9 +43,37 @@
 #endif
 
 #define GLFM_MAX_ACTIVE_TOUCHES 10
+#define GLFM_CANVAS_TARGET "#canvas"
+
+// Browsers don't expose the refresh rate, so the refresh interval is estimated from windows of this many frame
+// intervals. See glfm__updateRefreshInterval.
+#define GLFM_REFRESH_INTERVAL_WINDOW_FRAMES 120
+#define GLFM_REFRESH_INTERVAL_MIN_SAMPLES 10
+#define GLFM_REFRESH_INTERVAL_MIN 0.002
+#define GLFM_REFRESH_INTERVAL_STEADY_TOLERANCE 0.1
+#define GLFM_REFRESH_INTERVAL_PERCENTILE 0.05
+#define GLFM_REFRESH_INTERVAL_CLUSTER_SCALE 1.5
+
+#if GLFM_FEATURE_SENSORS
+// Sensor samples are written by JavaScript into a ring of records (sensor, timestamp, x, y, z),
+// and read once per frame.
+#  define GLFM_SENSOR_RING_SIZE 64
+#  define GLFM_SENSOR_RING_FIELDS 5
+#  define GLFM_STANDARD_GRAVITY 9.80665
+#endif
+
+// When input batching is enabled, input events are written by JavaScript into a ring of GLFMBatchedInputEvent records,
+// and read once per frame. Moves (and wheel events) are dropped when fewer than GLFM_INPUT_RING_RESERVED records are
+// free, so that the ring rarely fills up with the events that change input state (like touch end and key up).
+#define GLFM_INPUT_RING_SIZE 256
+#define GLFM_INPUT_RING_RESERVED 64
 
-// If 1, test if keyboard event arrays are sorted.
-#define GLFM_TEST_KEYBOARD_EVENT_ARRAYS 0
+// The rings and the canvas size are written by JavaScript on the browser's main thread. With
+// GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS, they are read on the app thread, so the counts are accessed atomically (the
+// JavaScript side uses Atomics).
+#define GLFM_ATOMIC_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define GLFM_ATOMIC_STORE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#define GLFM_ATOMIC_EXCHANGE(ptr, value) __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL)
 
 #ifdef EM_JS_DEPS
 #pragma clang diagnostic push
@@ -39,12 +88,35 @@ typedef struct {
     bool active;
 } GLFMActiveTouch;
 
+/// An input event written by the JavaScript listeners. See glfm__setBatchedInputListeners.
+typedef struct {
+    /// The index in GLFM_BATCHED_INPUT_EVENT_TYPES.
+    int32_t type;
+    /// The mouse button, the wheel delta mode, or the key modifiers (GLFMKeyModifier, plus 1 << 8 if repeated).
+    int32_t flags;
+    /// The event's timeStamp, in seconds.
+    double timestamp;
+    /// Touch: identifier, x, y. Mouse: x, y, canvas width, canvas height. Wheel: x, y, delta x, delta y, delta z.
+    /// Positions are relative to the canvas, in CSS pixels.
+    double values[6];
+    char code[32];
+    char key[32];
+} GLFMBatchedInputEvent;
+
 typedef struct {
     bool multitouchEnabled;
     int32_t width;
     int32_t height;
     double scale;
     GLFMRenderingAPI renderingAPI;
+    EMSCRIPTEN_WEBGL_CONTEXT_HANDLE contextHandle;
+    bool contextLost;
+    // True if the context was created with preserveDrawingBuffer
+    bool drawingBufferPreserved;
+    // True if the drawing buffer has the contents of the previous frame (if preserved). See glfmGetBufferAge.
+    bool drawingBufferValid;
+    // Space-separated list of enabled extensions, with and without the "GL_" prefix. See glfm__enableExtensions.
+    char *enabledExtensions;
 
     bool mouseDown;
     GLFMActiveTouch activeTouches[GLFM_MAX_ACTIVE_TOUCHES];
@@ -52,42 +124,77 @@ typedef struct {
     bool isVisible;
     bool isFocused;
     bool refreshRequested;
+    double lastFrameTime;
+
+    // Refresh interval estimate. See glfm__updateRefreshInterval.
+    double refreshInterval;
+    double refreshIntervalSamples[GLFM_REFRESH_INTERVAL_WINDOW_FRAMES];
+    double refreshIntervalPrevious;
+    int refreshIntervalSampleCount;
+    int refreshIntervalWindowFrames;
+
+    // Main loop timing: -1 if paused, 0 if run on requestAnimationFrame, otherwise the timer interval in milliseconds.
+    // See glfm__updateMainLoop.
+    bool mainLoopStarted;
+    int mainLoopInterval;
+
+    // Canvas size in device pixels, written by the ResizeObserver. See glfm__observeCanvasSize.
+    int32_t canvasPixelWidth;
+    int32_t canvasPixelHeight;
+    int32_t canvasPixelSizeChanged;
+    double canvasRenderScale;
 
     GLFMInterfaceOrientation orientation;
-} GLFMPlatformData;
 
-// MARK: - GLFM private functions
+#if GLFM_FEATURE_SENSORS
+    double sensorRing[GLFM_SENSOR_RING_SIZE][GLFM_SENSOR_RING_FIELDS];
+    uint32_t sensorRingWriteCount;
+    uint32_t sensorRingReadCount;
+    GLFMSensorEvent sensorEventBatch[GLFM_NUM_SENSORS][GLFM_SENSOR_RING_SIZE];
+    int sensorEventBatchCount[GLFM_NUM_SENSORS];
+#endif
 
-#if GLFM_TEST_KEYBOARD_EVENT_ARRAYS
+    GLFMBatchedInputEvent inputRing[GLFM_INPUT_RING_SIZE];
+    uint32_t inputRingWriteCount;
+    uint32_t inputRingReadCount;
+    uint32_t inputRingOverflowed;
 
-static bool glfm__listIsSorted(const char *list[], size_t size) {
-    for (size_t i = 1; i < size; i++) {
-        if (strcmp(list[i - 1], list[i]) > 0) {
-            return false;
-        }
-    }
-    return true;
-}
+    bool inputListenersReady;
+    bool inputListenersBatched;
+    int inputListeners;
+    int inputListenersHandled;
 
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+    pthread_t appThread;
 #endif
+} GLFMPlatformData;
 
-static int glfm__sortedListSearch(const char *list[], size_t size, const char *word) {
-    int left = 0;
-    int right = (int)size - 1;
-
-    while (left <= right) {
-        int index = (left + right) / 2;
-        int result = strcmp(list[index], word);
-        if (result > 0) {
-            right = index - 1;
-        } else if (result < 0) {
-            left = index + 1;
-        } else {
-            return index;
-        }
-    }
-    return -1;
-}
+// Extensions enabled if the app doesn't call glfmSetEnabledExtensions. Extensions that are part of WebGL 2 (like
+// ANGLE_instanced_arrays) are only available in WebGL 1.
+static const char *GLFM_DEFAULT_WEBGL_EXTENSIONS[] = {
+    "ANGLE_instanced_arrays",
+    "OES_vertex_array_object",
+    "OES_element_index_uint",
+    "WEBGL_compressed_texture_s3tc",
+    "WEBGL_compressed_texture_s3tc_srgb",
+    "WEBGL_compressed_texture_etc",
+    "WEBGL_compressed_texture_etc1",
+    "WEBGL_compressed_texture_astc",
+    "WEBGL_compressed_texture_pvrtc",
+    "EXT_texture_compression_bptc",
+    "EXT_texture_compression_rgtc",
+    "EXT_disjoint_timer_query",
+    "EXT_disjoint_timer_query_webgl2",
+    "KHR_parallel_shader_compile",
+    "WEBGL_multi_draw",
+};
+
+// MARK: - Private function declarations
+
+static void glfm__drainInputRing(GLFMDisplay *display);
+static void glfm__discardInputRing(GLFMDisplay *display);
+
+// MARK: - GLFM private functions
 
 static void glfm__clearActiveTouches(GLFMPlatformData *platformData) {
     for (int i = 0; i < GLFM_MAX_ACTIVE_TOUCHES; i++) {
@@ -99,17 +206,316 @@ static void glfm__displayChromeUpdated(GLFMDisplay *display) {
     (void)display;
 }
 
+#if GLFM_FEATURE_SENSORS
+
+void glfm__sensorFuncUpdated(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    GLFMPlatformData *platformData = display->platformData;
+    int sensorMask = 0;
+    if (platformData->isVisible && platformData->isFocused) {
+        for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+            if (glfm__isSensorRequested(display, i)) {
+                sensorMask |= (1 << i);
+            }
+        }
+    }
+
+    // The listeners write samples into the ring without calling into wasm. The ring is drained in glfm__mainLoopFunc.
+    // On Safari (iOS 13+), motion events require permission, which can only be requested from a user gesture.
+    MAIN_THREAD_EM_ASM({
+        var sensors = Module['glfmSensors'];
+        if (!sensors) {
+            if ($0 == 0) {
+                return;
+            }
+            var ring = $1 >> 3;
+            var writeCountIndex = $2 >> 2;
+            var ringSize = $3;
+            var accelerometer = $4;
+            var gyroscope = $5;
+            var rotation = $6;
+            sensors = Module['glfmSensors'] = {
+                mask: 0,
+                motionEnabled: false,
+                orientationEnabled: false,
+                permissionRequested: false,
+                permissionGranted: !(window.DeviceMotionEvent &&
+                                     typeof window.DeviceMotionEvent.requestPermission === 'function'),
+                orientationEventType: ('ondeviceorientationabsolute' in window) ?
+                    'deviceorientationabsolute' : 'deviceorientation'
+            };
+            sensors.write = function(sensor, timestamp, x, y, z) {
+                var writeCount = Atomics.load(HEAPU32, writeCountIndex);
+                var index = ring + (writeCount % ringSize) * 5;
+                HEAPF64[index + 0] = sensor;
+                HEAPF64[index + 1] = timestamp;
+                HEAPF64[index + 2] = x;
+                HEAPF64[index + 3] = y;
+                HEAPF64[index + 4] = z;
+                Atomics.store(HEAPU32, writeCountIndex, (writeCount + 1) >>> 0);
+            };
+            sensors.onMotion = function(event) {
+                var timestamp = event.timeStamp / 1000;
+                var a = event.accelerationIncludingGravity;
+                if ((sensors.mask & (1 << accelerometer)) && a && a.x !== null) {
+                    sensors.write(accelerometer, timestamp, a.x, a.y, a.z);
+                }
+                var r = event.rotationRate;
+                if ((sensors.mask & (1 << gyroscope)) && r && r.alpha !== null) {
+                    sensors.write(gyroscope, timestamp, r.beta, r.gamma, r.alpha);
+                }
+            };
+            sensors.onOrientation = function(event) {
+                if ((sensors.mask & (1 << rotation)) && event.alpha !== null) {
+                    sensors.write(rotation, event.timeStamp / 1000, event.alpha, event.beta, event.gamma);
+                }
+            };
+            sensors.requestPermission = function() {
+                window.removeEventListener('touchend', sensors.requestPermission, true);
+                window.removeEventListener('click', sensors.requestPermission, true);
+                window.DeviceMotionEvent.requestPermission().then(function(state) {
+                    sensors.permissionGranted = (state === 'granted');
+                    sensors.update();
+                }).catch(function() { });
+                if (window.DeviceOrientationEvent &&
+                    typeof window.DeviceOrientationEvent.requestPermission === 'function') {
+                    window.DeviceOrientationEvent.requestPermission().catch(function() { });
+                }
+            };
+            sensors.update = function() {
+                if (sensors.mask != 0 && !sensors.permissionGranted && !sensors.permissionRequested) {
+                    sensors.permissionRequested = true;
+                    window.addEventListener('touchend', sensors.requestPermission, true);
+                    window.addEventListener('click', sensors.requestPermission, true);
+                }
+                var motionMask = (1 << accelerometer) | (1 << gyroscope);
+                var motionEnabled = sensors.permissionGranted && (sensors.mask & motionMask) != 0;
+                if (motionEnabled != sensors.motionEnabled) {
+                    sensors.motionEnabled = motionEnabled;
+                    if (motionEnabled) {
+                        window.addEventListener('devicemotion', sensors.onMotion);
+                    } else {
+                        window.removeEventListener('devicemotion', sensors.onMotion);
+                    }
+                }
+                var orientationEnabled = sensors.permissionGranted && (sensors.mask & (1 << rotation)) != 0;
+                if (orientationEnabled != sensors.orientationEnabled) {
+                    sensors.orientationEnabled = orientationEnabled;
+                    if (orientationEnabled) {
+                        window.addEventListener(sensors.orientationEventType, sensors.onOrientation);
+                    } else {
+                        window.removeEventListener(sensors.orientationEventType, sensors.onOrientation);
+                    }
+                }
+            };
+        }
+        sensors.mask = $0;
+        sensors.update();
+    }, sensorMask, platformData->sensorRing, &platformData->sensorRingWriteCount, GLFM_SENSOR_RING_SIZE,
+       GLFMSensorAccelerometer, GLFMSensorGyroscope, GLFMSensorRotationMatrix);
+
+    if (sensorMask == 0) {
+        // Discard queued samples
+        platformData->sensorRingReadCount = GLFM_ATOMIC_LOAD(&platformData->sensorRingWriteCount);
+    }
+    for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+        if ((sensorMask & (1 << i)) == 0) {
+            glfm__clearSensorHistory(display, i);
+        }
+    }
+}
+
+#else
+
 void glfm__sensorFuncUpdated(GLFMDisplay *display) {
     (void)display;
-    // TODO: Sensors
 }
 
+#endif
+
+/// Gets the offset, in seconds, from DOM event timestamps to glfmGetTime().
+///
+/// Event timestamps are relative to performance.timeOrigin of the main thread, where the events occur. The timebase of
+/// emscripten_get_now() depends on the build: it may be performance.now() of the calling thread (which, on a worker,
+/// has a different time origin), or the time since the epoch (with pthreads). Both are converted to the time since the
+/// epoch on the calling thread to find the offset.
+static double glfm__getEventTimeOffset(void) {
+    static bool initialized = false;
+    static double offset = 0.0;
+    if (!initialized) {
+        const double mainTimeOrigin = MAIN_THREAD_EM_ASM_DOUBLE({
+            return performance.timeOrigin;
+        });
+        const double epochNow = EM_ASM_DOUBLE({
+            return performance.timeOrigin + performance.now();
+        });
+        const double now = emscripten_get_now();
+        offset = (now - (epochNow - mainTimeOrigin)) / 1000.0;
+        initialized = true;
+    }
+    return offset;
+}
+
+static double glfm__getSensorTimestamp(double time) {
+    // Sensor timestamps are DOM event timestamps
+    return time - glfm__getEventTimeOffset();
+}
+
+/// Converts a DOM event timeStamp, in seconds, to the ``glfmGetTime`` timebase.
+static double glfm__getEventTime(double time) {
+    return time + glfm__getEventTimeOffset();
+}
+
+#if GLFM_FEATURE_SENSORS
+
+static void glfm__convertSensorSample(const double *sample, GLFMSensorEvent *sensorEvent) {
+    const double toRadians = M_PI / 180.0;
+    sensorEvent->sensor = (GLFMSensor)(int)sample[0];
+    sensorEvent->timestamp = sample[1];
+    if (sensorEvent->sensor == GLFMSensorAccelerometer) {
+        // Convert to iOS format (same as Android)
+        sensorEvent->vector.x = sample[2] / -GLFM_STANDARD_GRAVITY;
+        sensorEvent->vector.y = sample[3] / -GLFM_STANDARD_GRAVITY;
+        sensorEvent->vector.z = sample[4] / -GLFM_STANDARD_GRAVITY;
+    } else if (sensorEvent->sensor == GLFMSensorGyroscope) {
+        // Rotation rate (beta, gamma, alpha) in degrees/second
+        sensorEvent->vector.x = sample[2] * toRadians;
+        sensorEvent->vector.y = sample[3] * toRadians;
+        sensorEvent->vector.z = sample[4] * toRadians;
+    } else if (sensorEvent->sensor == GLFMSensorRotationMatrix) {
+        // Convert the DeviceOrientation angles (alpha, beta, gamma; intrinsic Z-X'-Y'') to a unit quaternion.
+        // See https://www.w3.org/TR/orientation-event/
+        const double halfX = sample[3] * toRadians / 2.0;
+        const double halfY = sample[4] * toRadians / 2.0;
+        const double halfZ = sample[2] * toRadians / 2.0;
+        const double cx = cos(halfX);
+        const double cy = cos(halfY);
+        const double cz = cos(halfZ);
+        const double sx = sin(halfX);
+        const double sy = sin(halfY);
+        const double sz = sin(halfZ);
+        const double qw = cx * cy * cz - sx * sy * sz;
+        const double qx = sx * cy * cz - cx * sy * sz;
+        const double qy = cx * sy * cz + sx * cy * sz;
+        const double qz = cx * cy * sz + sx * sy * cz;
+
+        // Convert to the same reference frame as iOS (X axis points north), then to a rotation matrix.
+        // This is the same conversion as the Android rotation vector.
+        const double qx_ = qy + qx;
+        const double qy_ = qy - qx;
+        const double qz_ = qz - qw;
+        const double qw_ = qz + qw;
+
+        const double qxx2 = qx_ * qx_;
+        const double qxy2 = qx_ * qy_;
+        const double qxz2 = qx_ * qz_;
+        const double qxw2 = qx_ * qw_;
+        const double qyy2 = qy_ * qy_;
+        const double qyz2 = qy_ * qz_;
+        const double qyw2 = qy_ * qw_;
+        const double qzz2 = qz_ * qz_;
+        const double qzw2 = qz_ * qw_;
+
+        sensorEvent->matrix.m00 = 1 - qyy2 - qzz2;
+        sensorEvent->matrix.m10 = qxy2 - qzw2;
+        sensorEvent->matrix.m20 = qxz2 + qyw2;
+        sensorEvent->matrix.m01 = qxy2 + qzw2;
+        sensorEvent->matrix.m11 = 1 - qxx2 - qzz2;
+        sensorEvent->matrix.m21 = qyz2 - qxw2;
+        sensorEvent->matrix.m02 = qxz2 - qyw2;
+        sensorEvent->matrix.m12 = qyz2 + qxw2;
+        sensorEvent->matrix.m22 = 1 - qxx2 - qyy2;
+    }
+}
+
+static void glfm__drainSensorRing(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    const uint32_t writeCount = GLFM_ATOMIC_LOAD(&platformData->sensorRingWriteCount);
+    uint32_t readCount = platformData->sensorRingReadCount;
+    if (readCount == writeCount) {
+        return;
+    }
+    if (writeCount - readCount > GLFM_SENSOR_RING_SIZE) {
+        // Overflow; skip the oldest samples
+        readCount = writeCount - GLFM_SENSOR_RING_SIZE;
+    }
+    for (; readCount != writeCount; readCount++) {
+        GLFMSensorEvent sensorEvent = { 0 };
+        glfm__convertSensorSample(platformData->sensorRing[readCount % GLFM_SENSOR_RING_SIZE], &sensorEvent);
+        const int index = (int)sensorEvent.sensor;
+        if (index >= 0 && index < GLFM_NUM_SENSORS) {
+            platformData->sensorEventBatch[index][platformData->sensorEventBatchCount[index]++] = sensorEvent;
+            glfm__addSensorHistory(display, &sensorEvent);
+        }
+    }
+    platformData->sensorRingReadCount = readCount;
+
+    // Send callbacks
+    for (int i = 0; i < GLFM_NUM_SENSORS; i++) {
+        const int count = platformData->sensorEventBatchCount[i];
+        platformData->sensorEventBatchCount[i] = 0;
+        if (count == 0) {
+            continue;
+        }
+        if (display->sensorBatchFuncs[i]) {
+            display->sensorBatchFuncs[i](display, platformData->sensorEventBatch[i], count);
+        }
+        if (display->sensorFuncs[i]) {
+            display->sensorFuncs[i](display, platformData->sensorEventBatch[i][count - 1]);
+        }
+    }
+}
+
+#endif
+
+#if GLFM_FEATURE_CLIPBOARD
+
 EMSCRIPTEN_KEEPALIVE extern
 void glfm__requestClipboardTextCallback(GLFMDisplay *display,
                                         GLFMClipboardTextFunc clipboardTextFunc, const char *text);
 
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+
+typedef struct {
+    GLFMDisplay *display;
+    GLFMClipboardTextFunc clipboardTextFunc;
+    char text[];
+} GLFMClipboardTextResult;
+
+static void glfm__sendClipboardTextResult(void *arg) {
+    GLFMClipboardTextResult *result = arg;
+    glfm__requestClipboardTextCallback(result->display, result->clipboardTextFunc, result->text);
+    free(result);
+}
+
+#endif
+
 void glfm__requestClipboardTextCallback(GLFMDisplay *display,
                                         GLFMClipboardTextFunc clipboardTextFunc, const char *text) {
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+    // The clipboard is read on the browser's main thread. Send the text to the app thread.
+    GLFMPlatformData *platformData = display->platformData;
+    if (!pthread_equal(pthread_self(), platformData->appThread)) {
+        const size_t length = text ? strlen(text) : 0;
+        GLFMClipboardTextResult *result = malloc(sizeof(GLFMClipboardTextResult) + length + 1);
+        if (!result) {
+            return;
+        }
+        result->display = display;
+        result->clipboardTextFunc = clipboardTextFunc;
+        if (length > 0) {
+            memcpy(result->text, text, length);
+        }
+        result->text[length] = '\0';
+        if (!emscripten_proxy_async(emscripten_proxy_get_system_queue(), platformData->appThread,
+                                    glfm__sendClipboardTextResult, result)) {
+            free(result);
+        }
+        return;
+    }
+#endif
     if (text && text[0] != '\0') {
         clipboardTextFunc(display, text);
     } else {
@@ -117,6 +523,8 @@ void glfm__requestClipboardTextCallback(GLFMDisplay *display,
     }
 }
 
+#endif
+
 // MARK: - GLFM public functions
 
 double glfmGetTime(void) {
@@ -128,6 +536,30 @@ void glfmSwapBuffers(GLFMDisplay *display) {
     // Do nothing; swap is implicit
 }
 
+void glfmSwapBuffersWithDamage(GLFMDisplay *display, const GLFMRect *rects, int count) {
+    (void)rects;
+    (void)count;
+    // The browser always composites the entire canvas
+    glfmSwapBuffers(display);
+}
+
+void glfmSetDamageRegion(GLFMDisplay *display, const GLFMRect *rects, int count) {
+    (void)display;
+    (void)rects;
+    (void)count;
+}
+
+int glfmGetBufferAge(GLFMDisplay *display) {
+    if (!display || !display->platformData) {
+        return 0;
+    }
+    // With preserveDrawingBuffer, the drawing buffer keeps the previous frame, unless the canvas was resized or the
+    // context was lost since then. Otherwise, the drawing buffer is cleared after each frame.
+    GLFMPlatformData *platformData = display->platformData;
+    return (platformData->drawingBufferPreserved && platformData->drawingBufferValid &&
+            !platformData->contextLost) ? 1 : 0;
+}
+
 void glfmSetSupportedInterfaceOrientation(GLFMDisplay *display, GLFMInterfaceOrientation supportedOrientations) {
     if (display->supportedOrientations != supportedOrientations) {
         display->supportedOrientations = supportedOrientations;
@@ -185,31 +617,44 @@ double glfmGetDisplayScale(const GLFMDisplay *display) {
     return platformData->scale;
 }
 
+GLFMSurfaceTransform glfmGetSurfaceTransformHint(const GLFMDisplay *display) {
+    (void)display;
+    return GLFMSurfaceTransformIdentity;
+}
+
+GLFMSurfaceTransform glfmGetPreTransform(const GLFMDisplay *display, float matrix[16]) {
+    (void)display;
+    if (matrix) {
+        glfm__getPreTransformMatrix(GLFMSurfaceTransformIdentity, matrix);
+    }
+    return GLFMSurfaceTransformIdentity;
+}
+
 void glfmGetDisplayChromeInsets(const GLFMDisplay *display, double *top, double *right, double *bottom, double *left) {
     GLFMPlatformData *platformData = display->platformData;
     if (top) {
-        *top = platformData->scale * EM_ASM_DOUBLE_V( {
+        *top = platformData->scale * MAIN_THREAD_EM_ASM_DOUBLE( {
             var htmlStyles = window.getComputedStyle(document.querySelector("html"));
             return ((parseInt(htmlStyles.getPropertyValue("--glfm-chrome-top-old")) || 0) +
                     (parseInt(htmlStyles.getPropertyValue("--glfm-chrome-top")) || 0));
         } );
     }
     if (right) {
-        *right = platformData->scale * EM_ASM_DOUBLE_V( {
+        *right = platformData->scale * MAIN_THREAD_EM_ASM_DOUBLE( {
             var htmlStyles = window.getComputedStyle(document.querySelector("html"));
             return ((parseInt(htmlStyles.getPropertyValue("--glfm-chrome-right-old")) || 0) +
                     (parseInt(htmlStyles.getPropertyValue("--glfm-chrome-right")) || 0));
         } );
     }
     if (bottom) {
-        *bottom = platformData->scale * EM_ASM_DOUBLE_V( {
+        *bottom = platformData->scale * MAIN_THREAD_EM_ASM_DOUBLE( {
             var htmlStyles = window.getComputedStyle(document.querySelector("html"));
             return ((parseInt(htmlStyles.getPropertyValue("--glfm-chrome-bottom-old")) || 0) +
                     (parseInt(htmlStyles.getPropertyValue("--glfm-chrome-bottom")) || 0));
         } );
     }
     if (left) {
-        *left = platformData->scale * EM_ASM_DOUBLE_V( {
+        *left = platformData->scale * MAIN_THREAD_EM_ASM_DOUBLE( {
             var htmlStyles = window.getComputedStyle(document.querySelector("html"));
             return ((parseInt(htmlStyles.getPropertyValue("--glfm-chrome-left-old")) || 0) +
                     (parseInt(htmlStyles.getPropertyValue("--glfm-chrome-left")) || 0));
@@ -224,7 +669,7 @@ GLFMRenderingAPI glfmGetRenderingAPI(const GLFMDisplay *display) {
 
 bool glfmHasTouch(const GLFMDisplay *display) {
     (void)display;
-    return EM_ASM_INT_V({
+    return MAIN_THREAD_EM_ASM_INT({
         return (('ontouchstart' in window) || (navigator.msMaxTouchPoints > 0));
     });
 }
@@ -256,7 +701,7 @@ void glfmSetMouseCursor(GLFMDisplay *display, GLFMMouseCursor mouseCursor) {
             emCursor = 6;
             break;
     }
-    EM_ASM_({
+    MAIN_THREAD_EM_ASM({
         var emCursors = new Array('auto', 'none', 'default', 'pointer', 'crosshair', 'text', 'vertical-text');
         Module['canvas'].style.cursor = emCursors[$0];
     }, emCursor);
@@ -272,6 +717,11 @@ bool glfmGetMultitouchEnabled(const GLFMDisplay *display) {
     return platformData->multitouchEnabled;
 }
 
+void glfmLatchInput(GLFMDisplay *display) {
+    // Browser events are dispatched between frames, so only held touch moves are pending.
+    glfm__flushCoalescedTouches(display);
+}
+
 bool glfmHasVirtualKeyboard(const GLFMDisplay *display) {
     (void)display;
     return false;
@@ -292,13 +742,49 @@ GLFMProc glfmGetProcAddress(const char *functionName) {
     return eglGetProcAddress(functionName);
 }
 
+#if GLFM_FEATURE_SENSORS
+
 bool glfmIsSensorAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
+    (void)display;
+    switch (sensor) {
+        case GLFMSensorAccelerometer:
+        case GLFMSensorGyroscope:
+            return MAIN_THREAD_EM_ASM_INT({
+                return ('DeviceMotionEvent' in window) ? 1 : 0;
+            });
+        case GLFMSensorRotationMatrix:
+            return MAIN_THREAD_EM_ASM_INT({
+                return ('DeviceOrientationEvent' in window) ? 1 : 0;
+            });
+        case GLFMSensorMagnetometer:
+        default:
+            return false;
+    }
+}
+
+#endif // GLFM_FEATURE_SENSORS
+
+bool glfmIsSensorDirectChannelAvailable(const GLFMDisplay *display, GLFMSensor sensor) {
+    (void)display;
+    (void)sensor;
+    return false;
+}
+
+bool glfmSetSensorDirectChannelEnabled(GLFMDisplay *display, GLFMSensor sensor, bool enabled) {
     (void)display;
     (void)sensor;
-    // TODO: Sensors
+    (void)enabled;
     return false;
 }
 
+int glfmReadSensorDirectChannel(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorEvent *events, int maxEvents) {
+    (void)display;
+    (void)sensor;
+    (void)events;
+    (void)maxEvents;
+    return 0;
+}
+
 bool glfmIsHapticFeedbackSupported(const GLFMDisplay *display) {
     (void)display;
     return false;
@@ -310,10 +796,12 @@ void glfmPerformHapticFeedback(GLFMDisplay *display, GLFMHapticFeedbackStyle sty
     // Do nothing
 }
 
+#if GLFM_FEATURE_CLIPBOARD
+
 bool glfmHasClipboardText(const GLFMDisplay *display) {
     (void)display;
     // Currently, chrome supports navigator.userActivation, but Safari and Firefox do not.
-    int result = EM_ASM_INT({
+    int result = MAIN_THREAD_EM_ASM_INT({
         var hasReadText = (navigator && navigator.clipboard && navigator.clipboard.readText);
         var hasUserActivation = (navigator && navigator.userActivation) ? navigator.userActivation.isActive : true;
         return (hasReadText && hasUserActivation) ? 1 : 0;
@@ -330,7 +818,7 @@ void glfmRequestClipboardText(GLFMDisplay *display, GLFMClipboardTextFunc clipbo
         return;
     }
 
-    EM_ASM({
+    MAIN_THREAD_EM_ASM({
         if (!navigator.clipboard || !navigator.clipboard.readText) {
             _glfm__requestClipboardTextCallback($0, $1, null);
             return;
@@ -369,7 +857,7 @@ bool glfmSetClipboardText(GLFMDisplay *display, const char *string) {
     if (!string) {
         return false;
     }
-    int result = EM_ASM_INT({
+    int result = MAIN_THREAD_EM_ASM_INT({
         if (navigator.clipboard && navigator.clipboard.writeText) {
             var text = UTF8ToString($0);
             if (text) {
@@ -382,6 +870,8 @@ bool glfmSetClipboardText(GLFMDisplay *display, const char *string) {
     return result == 1;
 }
 
+#endif
+
 // MARK: - Platform-specific functions
 
 bool glfmIsMetalSupported(const GLFMDisplay *display) {
@@ -391,37 +881,252 @@ bool glfmIsMetalSupported(const GLFMDisplay *display) {
 
 // MARK: - Emscripten glue
 
-static int glfm__getDisplayWidth(GLFMDisplay *display) {
-    (void)display;
-    const double width = EM_ASM_DOUBLE_V({
+/// Observes the size of the canvas element. The observer writes the size in device pixels to platformData and sets
+/// `canvasPixelSizeChanged`, so the main loop doesn't need to query the layout every frame.
+static void glfm__observeCanvasSize(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    MAIN_THREAD_EM_ASM({
         var canvas = Module['canvas'];
-        return canvas.width;
-    });
-    return (int)(round(width));
+        var widthIndex = $0 >> 2;
+        var heightIndex = $1 >> 2;
+        var changedIndex = $2 >> 2;
+        var setSize = function(width, height) {
+            Atomics.store(HEAP32, widthIndex, Math.max(1, Math.round(width)));
+            Atomics.store(HEAP32, heightIndex, Math.max(1, Math.round(height)));
+            Atomics.store(HEAP32, changedIndex, 1);
+        };
+        var setSizeFromClientSize = function() {
+            var devicePixelRatio = window.devicePixelRatio || 1;
+            setSize(canvas.clientWidth * devicePixelRatio, canvas.clientHeight * devicePixelRatio);
+        };
+        // Without devicePixelContentBoxSize, a devicePixelRatio change (like moving the window to another display)
+        // doesn't resize the content box, so watch for it separately.
+        var watchDevicePixelRatio = function() {
+            if (!window.matchMedia) {
+                return;
+            }
+            var query = window.matchMedia('(resolution: ' + (window.devicePixelRatio || 1) + 'dppx)');
+            if (query.addEventListener) {
+                query.addEventListener('change', function() {
+                    setSizeFromClientSize();
+                    watchDevicePixelRatio();
+                }, { once: true });
+            }
+        };
+        setSizeFromClientSize();
+        if (typeof ResizeObserver === 'undefined') {
+            window.addEventListener('resize', setSizeFromClientSize);
+            watchDevicePixelRatio();
+            return;
+        }
+        var observer = new ResizeObserver(function(entries) {
+            var entry = entries[entries.length - 1];
+            var size = entry.devicePixelContentBoxSize;
+            if (size && size.length > 0) {
+                setSize(size[0].inlineSize, size[0].blockSize);
+            } else {
+                setSizeFromClientSize();
+            }
+        });
+        try {
+            observer.observe(canvas, { box: 'device-pixel-content-box' });
+        } catch (e) {
+            observer.observe(canvas);
+            watchDevicePixelRatio();
+        }
+    }, &platformData->canvasPixelWidth, &platformData->canvasPixelHeight, &platformData->canvasPixelSizeChanged);
 }
 
-static int glfm__getDisplayHeight(GLFMDisplay *display) {
-    (void)display;
-    const double height = EM_ASM_DOUBLE_V({
-        var canvas = Module['canvas'];
-        return canvas.height;
-    });
-    return (int)(round(height));
+/// Sizes the canvas to the observed size at the current render scale. The canvas is sized below the element's size in
+/// device pixels when the render scale is less than 1, and the browser scales it up to fill the element.
+/// Returns true if the canvas size changed.
+static bool glfm__updateCanvasSize(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    const double renderScale = glfm__getRenderScale(display);
+    GLFM_ATOMIC_STORE(&platformData->canvasPixelSizeChanged, 0);
+    platformData->canvasRenderScale = renderScale;
+    platformData->scale = emscripten_get_device_pixel_ratio() * renderScale;
+
+    int32_t width = (int32_t)round(GLFM_ATOMIC_LOAD(&platformData->canvasPixelWidth) * renderScale);
+    int32_t height = (int32_t)round(GLFM_ATOMIC_LOAD(&platformData->canvasPixelHeight) * renderScale);
+    width = width < 1 ? 1 : width;
+    height = height < 1 ? 1 : height;
+    if (width == platformData->width && height == platformData->height) {
+        return false;
+    }
+    platformData->width = width;
+    platformData->height = height;
+    platformData->drawingBufferValid = false;
+    // With GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS, this sets the size of the OffscreenCanvas owned by the app thread.
+    emscripten_set_canvas_element_size(GLFM_CANVAS_TARGET, width, height);
+    return true;
+}
+
+/// Pauses the main loop while the page is hidden, or runs it on a timer if the app set a hidden frame rate. Browsers
+/// throttle requestAnimationFrame in hidden pages, but don't always stop it.
+static void glfm__updateMainLoop(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    if (!platformData->mainLoopStarted) {
+        return;
+    }
+    int interval;
+    if (platformData->isVisible) {
+        interval = 0;
+    } else if (display->hiddenFrameRate > 0.0) {
+        interval = (int)(1000.0 / display->hiddenFrameRate + 0.5);
+        if (interval < 1) {
+            interval = 1;
+        }
+    } else {
+        interval = -1;
+    }
+    if (platformData->mainLoopInterval == interval) {
+        return;
+    }
+    if (interval < 0) {
+        emscripten_pause_main_loop();
+    } else {
+        if (platformData->mainLoopInterval < 0) {
+            emscripten_resume_main_loop();
+        }
+        if (interval == 0) {
+            emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+        } else {
+            emscripten_set_main_loop_timing(EM_TIMING_SETTIMEOUT, interval);
+        }
+    }
+    platformData->mainLoopInterval = interval;
+    platformData->lastFrameTime = 0.0;
+}
+
+static char *glfm__copySupportedExtensions(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    if (!platformData || !platformData->enabledExtensions) {
+        return NULL;
+    }
+    char *copy = malloc(strlen(platformData->enabledExtensions) + 1);
+    if (copy) {
+        strcpy(copy, platformData->enabledExtensions);
+    }
+    return copy;
+}
+
+/// Enables the extensions set with glfmSetEnabledExtensions (or the default extensions), and records which ones were
+/// enabled for glfmIsExtensionSupported. Extensions must be enabled again after the context is restored.
+static void glfm__enableExtensions(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    const char *const *extensions = GLFM_DEFAULT_WEBGL_EXTENSIONS;
+    int count = (int)(sizeof(GLFM_DEFAULT_WEBGL_EXTENSIONS) / sizeof(*GLFM_DEFAULT_WEBGL_EXTENSIONS));
+    if (display->enabledExtensionsSet) {
+        extensions = (const char *const *)display->enabledExtensions;
+        count = display->enabledExtensionCount;
+    }
+
+    glfm__clearSupportedExtensions(display);
+    free(platformData->enabledExtensions);
+    platformData->enabledExtensions = NULL;
+
+    // Each name is listed twice, with and without the "GL_" prefix
+    size_t size = 1;
+    for (int i = 0; i < count; i++) {
+        size += 2 * strlen(extensions[i]) + 5;
+    }
+    char *list = malloc(size);
+    if (!list) {
+        return;
+    }
+    list[0] = '\0';
+    size_t length = 0;
+    for (int i = 0; i < count; i++) {
+        const char *name = extensions[i];
+        if (strncmp(name, "GL_", 3) == 0) {
+            name += 3;
+        }
+        if (name[0] != '\0' && emscripten_webgl_enable_extension(platformData->contextHandle, name)) {
+            int result = snprintf(list + length, size - length, "%s%s GL_%s", length > 0 ? " " : "", name, name);
+            if (result > 0) {
+                length += (size_t)result;
+            }
+        }
+    }
+    platformData->enabledExtensions = list;
+}
+
+static void glfm__hiddenFrameRateUpdated(GLFMDisplay *display) {
+    if (display && display->platformData) {
+        glfm__updateMainLoop(display);
+    }
 }
 
 static void glfm__setVisibleAndFocused(GLFMDisplay *display, bool visible, bool focused) {
     GLFMPlatformData *platformData = display->platformData;
+    bool wasVisible = platformData->isVisible;
     bool wasActive = platformData->isVisible && platformData->isFocused;
     platformData->isVisible = visible;
     platformData->isFocused = focused;
     bool isActive = platformData->isVisible && platformData->isFocused;
+    if (!wasVisible && visible) {
+        // Input events from while the page was hidden are stale
+        glfm__discardInputRing(display);
+    }
     if (wasActive != isActive) {
         platformData->refreshRequested = true;
         glfm__clearActiveTouches(platformData);
+        if (!isActive) {
+            glfm__clearKeysDown(display);
+        }
         if (display->focusFunc) {
             display->focusFunc(display, isActive);
         }
+        glfm__sensorFuncUpdated(display);
+    }
+    if (wasVisible != visible) {
+        glfm__updateMainLoop(display);
+    }
+}
+
+static int glfm__compareDoubles(const void *a, const void *b) {
+    const double valueA = *(const double *)a;
+    const double valueB = *(const double *)b;
+    return (valueA > valueB) - (valueA < valueB);
+}
+
+/// Updates the estimated refresh interval from the interval between two frames, and returns the estimate, or 0 until
+/// the first estimate is available.
+///
+/// The time each frame starts jitters. A late frame followed by an on-time frame measures one long interval and one
+/// interval far below the refresh interval, so only steady intervals (within 10% of the previous interval) are sampled.
+/// At the end of each window of frames, the estimate is the median of the fastest cluster of samples: those from the
+/// 5th percentile up to 1.5 times that. Any remaining outliers below the 5th percentile are ignored, and the estimate
+/// still follows the display's refresh rate (for example, 120Hz or 144Hz) while most frames are slower, as long as
+/// some frames keep up. Each window replaces the previous estimate, so it also follows a move to a slower display.
+static double glfm__updateRefreshInterval(GLFMPlatformData *platformData, double frameInterval) {
+    if (frameInterval < GLFM_REFRESH_INTERVAL_MIN) {
+        return platformData->refreshInterval;
+    }
+    const double previous = platformData->refreshIntervalPrevious;
+    platformData->refreshIntervalPrevious = frameInterval;
+    if (fabs(frameInterval - previous) <= previous * GLFM_REFRESH_INTERVAL_STEADY_TOLERANCE) {
+        platformData->refreshIntervalSamples[platformData->refreshIntervalSampleCount++] = frameInterval;
+    }
+    platformData->refreshIntervalWindowFrames++;
+    if (platformData->refreshIntervalWindowFrames == GLFM_REFRESH_INTERVAL_WINDOW_FRAMES) {
+        double *samples = platformData->refreshIntervalSamples;
+        const int count = platformData->refreshIntervalSampleCount;
+        if (count >= GLFM_REFRESH_INTERVAL_MIN_SAMPLES) {
+            qsort(samples, (size_t)count, sizeof(double), glfm__compareDoubles);
+            const int first = (int)(count * GLFM_REFRESH_INTERVAL_PERCENTILE);
+            const double clusterMax = samples[first] * GLFM_REFRESH_INTERVAL_CLUSTER_SCALE;
+            int last = first;
+            while (last + 1 < count && samples[last + 1] <= clusterMax) {
+                last++;
+            }
+            platformData->refreshInterval = samples[(first + last) / 2];
+        }
+        platformData->refreshIntervalSampleCount = 0;
+        platformData->refreshIntervalWindowFrames = 0;
     }
+    return platformData->refreshInterval;
 }
 
 static void glfm__mainLoopFunc(void *userData) {
@@ -429,30 +1134,35 @@ static void glfm__mainLoopFunc(void *userData) {
     if (display) {
         GLFMPlatformData *platformData = display->platformData;
 
-        // Check if canvas size has changed
-        int displayChanged = EM_ASM_INT_V({
-            var canvas = Module['canvas'];
-            var devicePixelRatio = window.devicePixelRatio || 1;
-            var width = canvas.clientWidth * devicePixelRatio;
-            var height = canvas.clientHeight * devicePixelRatio;
-            if (width != canvas.width || height != canvas.height) {
-                canvas.width = width;
-                canvas.height = height;
-                return 1;
-            } else {
-                return 0;
-            }
-        });
-        if (displayChanged) {
-            platformData->refreshRequested = true;
-            platformData->width = glfm__getDisplayWidth(display);
-            platformData->height = glfm__getDisplayHeight(display);
-            platformData->scale = emscripten_get_device_pixel_ratio();
-            if (display->surfaceResizedFunc) {
-                display->surfaceResizedFunc(display, platformData->width, platformData->height);
+        // Automatic render scale, targeting the estimated refresh interval. Frames run on a timer while hidden are not
+        // measured.
+        const double now = glfmGetTime();
+        if (platformData->lastFrameTime > 0.0) {
+            const double frameDuration = now - platformData->lastFrameTime;
+            glfm__updateAutomaticRenderScale(display, frameDuration,
+                                             glfm__updateRefreshInterval(platformData, frameDuration));
+        }
+        platformData->lastFrameTime = platformData->isVisible ? now : 0.0;
+
+        // Check if canvas size or render scale has changed
+        const double renderScale = glfm__getRenderScale(display);
+        if (GLFM_ATOMIC_LOAD(&platformData->canvasPixelSizeChanged) || renderScale < platformData->canvasRenderScale ||
+            renderScale > platformData->canvasRenderScale) {
+            if (glfm__updateCanvasSize(display)) {
+                platformData->refreshRequested = true;
+                if (display->surfaceResizedFunc) {
+                    display->surfaceResizedFunc(display, platformData->width, platformData->height);
+                }
             }
         }
 
+        // Batched input, sensor, and coalesced touch events
+        glfm__drainInputRing(display);
+#if GLFM_FEATURE_SENSORS
+        glfm__drainSensorRing(display);
+#endif
+        glfm__flushCoalescedTouches(display);
+
         // Tick
         if (platformData->refreshRequested) {
             platformData->refreshRequested = false;
@@ -460,9 +1170,14 @@ static void glfm__mainLoopFunc(void *userData) {
                 display->surfaceRefreshFunc(display);
             }
         }
+        if (!platformData->contextLost) {
+            glfm__createPendingResources(display);
+        }
         if (display->renderFunc) {
             display->renderFunc(display);
         }
+        glfm__clearEndedTouches(display);
+        platformData->drawingBufferValid = !platformData->contextLost;
     }
 }
 
@@ -473,11 +1188,17 @@ static EM_BOOL glfm__webGLContextCallback(int eventType, const void *reserved, v
     platformData->refreshRequested = true;
     switch (eventType) {
         case EMSCRIPTEN_EVENT_WEBGLCONTEXTLOST:
+            platformData->contextLost = true;
+            platformData->drawingBufferValid = false;
+            glfm__clearSupportedExtensions(display);
+            glfm__invalidateResources(display);
             if (display->surfaceDestroyedFunc) {
                 display->surfaceDestroyedFunc(display);
             }
             return 1;
         case EMSCRIPTEN_EVENT_WEBGLCONTEXTRESTORED:
+            platformData->contextLost = false;
+            glfm__enableExtensions(display);
             if (display->surfaceCreatedFunc) {
                 display->surfaceCreatedFunc(display, platformData->width, platformData->height);
             }
@@ -531,74 +1252,14 @@ static EM_BOOL glfm__orientationChangeCallback(int eventType,
     return 1;
 }
 
+#if GLFM_FEATURE_KEYBOARD
+
 static EM_BOOL glfm__keyCallback(int eventType, const EmscriptenKeyboardEvent *event, void *userData) {
     GLFMDisplay *display = userData;
     EM_BOOL handled = 0;
 
     // Key input
-    if (display->keyFunc && (eventType == EMSCRIPTEN_EVENT_KEYDOWN || eventType == EMSCRIPTEN_EVENT_KEYUP)) {
-        // This list of code values is from https://www.w3.org/TR/uievents-code/
-        // (Added functions keys F13-F24)
-        // egrep -o '<code class="code" id="code-.*?</code>' uievents-code.html | sort | awk -F"[><]" '{print $3}' | awk 1 ORS=', '
-        // This array must be sorted for binary search. See GLFM_TEST_KEYBOARD_EVENT_ARRAYS.
-        // NOTE: event->keyCode is obsolete. Only event->key or event->code should be used.
-        static const char *KEYBOARD_EVENT_CODES[] = {
-            "AltLeft", "AltRight", "ArrowDown", "ArrowLeft", "ArrowRight", "ArrowUp", "Backquote", "Backslash",
-            "Backspace", "BracketLeft", "BracketRight", "BrowserBack", "CapsLock", "Comma", "ContextMenu",
-            "ControlLeft", "ControlRight", "Delete", "Digit0", "Digit1", "Digit2", "Digit3", "Digit4", "Digit5",
-            "Digit6", "Digit7", "Digit8", "Digit9", "End", "Enter", "Equal", "Escape", "F1", "F10", "F11", "F12", "F13",
-            "F14", "F15", "F16", "F17", "F18", "F19", "F2", "F20", "F21", "F22", "F23", "F24", "F3", "F4", "F5", "F6",
-            "F7", "F8", "F9", "Fn", "Help", "Home", "Insert", "KeyA", "KeyB", "KeyC", "KeyD", "KeyE", "KeyF", "KeyG",
-            "KeyH", "KeyI", "KeyJ", "KeyK", "KeyL", "KeyM", "KeyN", "KeyO", "KeyP", "KeyQ", "KeyR", "KeyS", "KeyT",
-            "KeyU", "KeyV", "KeyW", "KeyX", "KeyY", "KeyZ", "MediaPlayPause", "MetaLeft", "MetaRight", "Minus",
-            "NumLock", "Numpad0", "Numpad1", "Numpad2", "Numpad3", "Numpad4", "Numpad5", "Numpad6", "Numpad7",
-            "Numpad8", "Numpad9", "NumpadAdd", "NumpadDecimal", "NumpadDivide", "NumpadEnter", "NumpadEqual",
-            "NumpadMultiply", "NumpadSubtract", "PageDown", "PageUp", "Pause", "Period", "Power", "PrintScreen",
-            "Quote", "ScrollLock", "Semicolon", "ShiftLeft", "ShiftRight", "Slash", "Space", "Tab",
-        };
-        static const size_t KEYBOARD_EVENT_CODES_LENGTH = sizeof(KEYBOARD_EVENT_CODES) / sizeof(*KEYBOARD_EVENT_CODES);
-        static const GLFMKeyCode GLFM_KEY_CODES[] = {
-            GLFMKeyCodeAltLeft, GLFMKeyCodeAltRight, GLFMKeyCodeArrowDown, GLFMKeyCodeArrowLeft,
-            GLFMKeyCodeArrowRight, GLFMKeyCodeArrowUp, GLFMKeyCodeBackquote, GLFMKeyCodeBackslash,
-            GLFMKeyCodeBackspace, GLFMKeyCodeBracketLeft, GLFMKeyCodeBracketRight, GLFMKeyCodeNavigationBack,
-            GLFMKeyCodeCapsLock, GLFMKeyCodeComma, GLFMKeyCodeMenu, GLFMKeyCodeControlLeft, GLFMKeyCodeControlRight,
-            GLFMKeyCodeDelete, GLFMKeyCode0, GLFMKeyCode1, GLFMKeyCode2, GLFMKeyCode3, GLFMKeyCode4, GLFMKeyCode5,
-            GLFMKeyCode6, GLFMKeyCode7, GLFMKeyCode8, GLFMKeyCode9, GLFMKeyCodeEnd, GLFMKeyCodeEnter, GLFMKeyCodeEqual,
-            GLFMKeyCodeEscape, GLFMKeyCodeF1, GLFMKeyCodeF10, GLFMKeyCodeF11, GLFMKeyCodeF12, GLFMKeyCodeF13,
-            GLFMKeyCodeF14, GLFMKeyCodeF15, GLFMKeyCodeF16, GLFMKeyCodeF17, GLFMKeyCodeF18, GLFMKeyCodeF19,
-            GLFMKeyCodeF2, GLFMKeyCodeF20, GLFMKeyCodeF21, GLFMKeyCodeF22, GLFMKeyCodeF23, GLFMKeyCodeF24,
-            GLFMKeyCodeF3, GLFMKeyCodeF4, GLFMKeyCodeF5, GLFMKeyCodeF6, GLFMKeyCodeF7, GLFMKeyCodeF8, GLFMKeyCodeF9,
-            GLFMKeyCodeFunction, GLFMKeyCodeInsert, GLFMKeyCodeHome, GLFMKeyCodeInsert, GLFMKeyCodeA, GLFMKeyCodeB,
-            GLFMKeyCodeC, GLFMKeyCodeD, GLFMKeyCodeE, GLFMKeyCodeF, GLFMKeyCodeG, GLFMKeyCodeH, GLFMKeyCodeI,
-            GLFMKeyCodeJ, GLFMKeyCodeK, GLFMKeyCodeL, GLFMKeyCodeM, GLFMKeyCodeN, GLFMKeyCodeO, GLFMKeyCodeP,
-            GLFMKeyCodeQ, GLFMKeyCodeR, GLFMKeyCodeS, GLFMKeyCodeT, GLFMKeyCodeU, GLFMKeyCodeV, GLFMKeyCodeW,
-            GLFMKeyCodeX, GLFMKeyCodeY, GLFMKeyCodeZ, GLFMKeyCodeMediaPlayPause, GLFMKeyCodeMetaLeft,
-            GLFMKeyCodeMetaRight, GLFMKeyCodeMinus, GLFMKeyCodeNumLock, GLFMKeyCodeNumpad0, GLFMKeyCodeNumpad1,
-            GLFMKeyCodeNumpad2, GLFMKeyCodeNumpad3, GLFMKeyCodeNumpad4, GLFMKeyCodeNumpad5, GLFMKeyCodeNumpad6,
-            GLFMKeyCodeNumpad7, GLFMKeyCodeNumpad8, GLFMKeyCodeNumpad9, GLFMKeyCodeNumpadAdd, GLFMKeyCodeNumpadDecimal,
-            GLFMKeyCodeNumpadDivide, GLFMKeyCodeNumpadEnter, GLFMKeyCodeNumpadEqual, GLFMKeyCodeNumpadMultiply,
-            GLFMKeyCodeNumpadSubtract, GLFMKeyCodePageDown, GLFMKeyCodePageUp, GLFMKeyCodePause ,GLFMKeyCodePeriod,
-            GLFMKeyCodePower, GLFMKeyCodePrintScreen, GLFMKeyCodeQuote, GLFMKeyCodeScrollLock, GLFMKeyCodeSemicolon,
-            GLFMKeyCodeShiftLeft, GLFMKeyCodeShiftRight, GLFMKeyCodeSlash, GLFMKeyCodeSpace, GLFMKeyCodeTab,
-        };
-
-#if GLFM_TEST_KEYBOARD_EVENT_ARRAYS
-        static bool KEYBOARD_EVENT_CODES_TESTED = false;
-        if (!KEYBOARD_EVENT_CODES_TESTED) {
-            KEYBOARD_EVENT_CODES_TESTED = true;
-            if (glfm__listIsSorted(KEYBOARD_EVENT_CODES, KEYBOARD_EVENT_CODES_LENGTH)) {
-                GLFM_LOG("Success: KEYBOARD_EVENT_CODES is sorted");
-            } else {
-                GLFM_LOG("Failure: KEYBOARD_EVENT_CODES is not sorted");
-            }
-            if (KEYBOARD_EVENT_CODES_LENGTH == sizeof(GLFM_KEY_CODES) / sizeof(*GLFM_KEY_CODES)) {
-                GLFM_LOG("Success: GLFM_KEYBOARD_EVENT_CODES is the correct length");
-            } else {
-                GLFM_LOG("Failure: GLFM_KEYBOARD_EVENT_CODES is not the correct length");
-            }
-        }
-#endif
-
+    if (eventType == EMSCRIPTEN_EVENT_KEYDOWN || eventType == EMSCRIPTEN_EVENT_KEYUP) {
         GLFMKeyAction action;
         if (eventType == EMSCRIPTEN_EVENT_KEYDOWN) {
             action = event->repeat ? GLFMKeyActionRepeated : GLFMKeyActionPressed;
@@ -624,83 +1285,20 @@ static EM_BOOL glfm__keyCallback(int eventType, const EmscriptenKeyboardEvent *e
             modifiers |= GLFMKeyModifierMeta;
         }
 
-        int codeIndex = glfm__sortedListSearch(KEYBOARD_EVENT_CODES, KEYBOARD_EVENT_CODES_LENGTH, event->code);
-        GLFMKeyCode keyCode = codeIndex >= 0 ? GLFM_KEY_CODES[codeIndex] : GLFMKeyCodeUnknown;
-        handled = display->keyFunc(display, keyCode, action, modifiers);
+        // NOTE: event->keyCode is obsolete. Only event->key or event->code should be used.
+        GLFMKeyCode keyCode = glfm__getKeyCode(event->code);
+        handled = glfm__sendKeyEvent(display, keyCode, action, modifiers);
     }
 
     // Character input
     if (display->charFunc && eventType == EMSCRIPTEN_EVENT_KEYDOWN && !event->ctrlKey && !event->metaKey) {
         // It appears the only way to detect printable character input is to check if the "key" value is
         // not one of the pre-defined key values.
-        // This list of pre-defined key values is from https://www.w3.org/TR/uievents-key/
-        // (Added functions keys F13-F24 and Soft5-Soft10)
-        // This array must be sorted for binary search. See GLFM_TEST_KEYBOARD_EVENT_ARRAYS.
-        // egrep -o '<code class="key" id="key-.*?</code>' uievents-key.html | sort | awk -F"[><]" '{print $3}' | awk 1 ORS=', '
-        static const char *KEYBOARD_EVENT_KEYS[] = {
-            "AVRInput", "AVRPower", "Accept", "Again", "AllCandidates", "Alphanumeric", "Alt", "AltGraph", "AppSwitch",
-            "ArrowDown", "ArrowLeft", "ArrowRight", "ArrowUp", "Attn", "AudioBalanceLeft", "AudioBalanceRight",
-            "AudioBassBoostDown", "AudioBassBoostToggle", "AudioBassBoostUp", "AudioFaderFront", "AudioFaderRear",
-            "AudioSurroundModeNext", "AudioTrebleDown", "AudioTrebleUp", "AudioVolumeDown", "AudioVolumeMute",
-            "AudioVolumeUp", "Backspace", "BrightnessDown", "BrightnessUp", "BrowserBack", "BrowserFavorites",
-            "BrowserForward", "BrowserHome", "BrowserRefresh", "BrowserSearch", "BrowserStop", "Call", "Camera",
-            "CameraFocus", "Cancel", "CapsLock", "ChannelDown", "ChannelUp", "Clear", "Close", "ClosedCaptionToggle",
-            "CodeInput", "ColorF0Red", "ColorF1Green", "ColorF2Yellow", "ColorF3Blue", "ColorF4Grey", "ColorF5Brown",
-            "Compose", "ContextMenu", "Control", "Convert", "Copy", "CrSel", "Cut", "DVR", "Dead", "Delete", "Dimmer",
-            "DisplaySwap", "Eisu", "Eject", "End", "EndCall", "Enter", "EraseEof", "Escape", "ExSel", "Execute", "Exit",
-            "F1", "F10", "F11", "F12", "F13", "F14", "F15", "F16", "F17", "F18", "F19", "F2",
-            "F20", "F21", "F22", "F23", "F24", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "FavoriteClear0",
-            "FavoriteClear1", "FavoriteClear2", "FavoriteClear3", "FavoriteRecall0", "FavoriteRecall1",
-            "FavoriteRecall2", "FavoriteRecall3", "FavoriteStore0", "FavoriteStore1", "FavoriteStore2",
-            "FavoriteStore3", "FinalMode", "Find", "Fn", "FnLock", "GoBack", "GoHome", "GroupFirst", "GroupLast",
-            "GroupNext", "GroupPrevious", "Guide", "GuideNextDay", "GuidePreviousDay", "HangulMode", "HanjaMode",
-            "Hankaku", "HeadsetHook", "Help", "Hibernate", "Hiragana", "HiraganaKatakana", "Home", "Hyper", "Info",
-            "Insert", "InstantReplay", "JunjaMode", "KanaMode", "KanjiMode", "Katakana", "Key11", "Key12",
-            "LastNumberRedial", "LaunchApplication1", "LaunchApplication2", "LaunchCalendar", "LaunchContacts",
-            "LaunchMail", "LaunchMediaPlayer", "LaunchMusicPlayer", "LaunchPhone", "LaunchScreenSaver",
-            "LaunchSpreadsheet", "LaunchWebBrowser", "LaunchWebCam", "LaunchWordProcessor", "Link", "ListProgram",
-            "LiveContent", "Lock", "LogOff", "MailForward", "MailReply", "MailSend", "MannerMode", "MediaApps",
-            "MediaAudioTrack", "MediaClose", "MediaFastForward", "MediaLast", "MediaPause", "MediaPlay",
-            "MediaPlayPause", "MediaRecord", "MediaRewind", "MediaSkipBackward", "MediaSkipForward",
-            "MediaStepBackward", "MediaStepForward", "MediaStop", "MediaTopMenu", "MediaTrackNext",
-            "MediaTrackPrevious", "Meta", "MicrophoneToggle", "MicrophoneVolumeDown", "MicrophoneVolumeMute",
-            "MicrophoneVolumeUp", "ModeChange", "NavigateIn", "NavigateNext", "NavigateOut", "NavigatePrevious", "New",
-            "NextCandidate", "NextFavoriteChannel", "NextUserProfile", "NonConvert", "Notification", "NumLock",
-            "OnDemand", "Open", "PageDown", "PageUp", "Pairing", "Paste", "Pause", "PinPDown", "PinPMove", "PinPToggle",
-            "PinPUp", "Play", "PlaySpeedDown", "PlaySpeedReset", "PlaySpeedUp", "Power", "PowerOff",
-            "PreviousCandidate", "Print", "PrintScreen", "Process", "Props", "RandomToggle", "RcLowBattery",
-            "RecordSpeedNext", "Redo", "RfBypass", "Romaji", "STBInput", "STBPower", "Save", "ScanChannelsToggle",
-            "ScreenModeNext", "ScrollLock", "Select", "Settings", "Shift", "SingleCandidate",
-            "Soft1", "Soft10", "Soft2", "Soft3", "Soft4", "Soft5", "Soft6", "Soft7", "Soft8", "Soft9",
-            "SpeechCorrectionList", "SpeechInputToggle", "SpellCheck", "SplitScreenToggle", "Standby",
-            "Subtitle", "Super", "Symbol", "SymbolLock", "TV", "TV3DMode", "TVAntennaCable", "TVAudioDescription",
-            "TVAudioDescriptionMixDown", "TVAudioDescriptionMixUp", "TVContentsMenu", "TVDataService", "TVInput",
-            "TVInputComponent1", "TVInputComponent2", "TVInputComposite1", "TVInputComposite2", "TVInputHDMI1",
-            "TVInputHDMI2", "TVInputHDMI3", "TVInputHDMI4", "TVInputVGA1", "TVMediaContext", "TVNetwork",
-            "TVNumberEntry", "TVPower", "TVRadioService", "TVSatellite", "TVSatelliteBS", "TVSatelliteCS",
-            "TVSatelliteToggle", "TVTerrestrialAnalog", "TVTerrestrialDigital", "TVTimer", "Tab", "Teletext",
-            "Undo", "Unidentified", "VideoModeNext", "VoiceDial", "WakeUp", "Wink", "Zenkaku", "ZenkakuHankaku",
-            "ZoomIn", "ZoomOut", "ZoomToggle",
-        };
-        static const size_t KEYBOARD_EVENT_KEYS_LENGTH = sizeof(KEYBOARD_EVENT_KEYS) / sizeof(*KEYBOARD_EVENT_KEYS);
-
-#if GLFM_TEST_KEYBOARD_EVENT_ARRAYS
-        static bool KEYBOARD_EVENT_KEYS_TESTED = false;
-        if (!KEYBOARD_EVENT_KEYS_TESTED) {
-            KEYBOARD_EVENT_KEYS_TESTED = true;
-            if (glfm__listIsSorted(KEYBOARD_EVENT_KEYS, KEYBOARD_EVENT_KEYS_LENGTH)) {
-                GLFM_LOG("Success: KEYBOARD_EVENT_KEYS is sorted");
-            } else {
-                GLFM_LOG("Failure: KEYBOARD_EVENT_KEYS is not sorted");
-            }
-        }
-#endif
         if (event->key[0] != '\0') {
             bool isSingleChar = (event->key[1] == '\0');
             bool isPredefinedKey = false;
             if (!isSingleChar) {
-                isPredefinedKey = glfm__sortedListSearch(KEYBOARD_EVENT_KEYS, KEYBOARD_EVENT_KEYS_LENGTH,
-                                                         event->key) >= 0;
+                isPredefinedKey = glfm__isPredefinedKey(event->key);
             }
             if (isSingleChar || !isPredefinedKey) {
                 display->charFunc(display, event->key, 0);
@@ -712,36 +1310,26 @@ static EM_BOOL glfm__keyCallback(int eventType, const EmscriptenKeyboardEvent *e
     return handled;
 }
 
-static EM_BOOL glfm__mouseCallback(int eventType, const EmscriptenMouseEvent *event, void *userData) {
-    GLFMDisplay *display = userData;
+#endif // GLFM_FEATURE_KEYBOARD
+
+/// Handles a mouse event. The position is relative to the canvas, in CSS pixels. The timestamp is in the
+/// ``glfmGetTime`` timebase.
+static EM_BOOL glfm__handleMouseEvent(GLFMDisplay *display, int eventType, int button, float mouseX, float mouseY,
+                                      float canvasW, float canvasH, double timestamp) {
     GLFMPlatformData *platformData = display->platformData;
-    if (!display->touchFunc) {
-        platformData->mouseDown = false;
+    const bool mouseInside = mouseX >= 0 && mouseY >= 0 && mouseX < canvasW && mouseY < canvasH;
+    if (eventType == EMSCRIPTEN_EVENT_MOUSELEAVE || (!mouseInside && !platformData->mouseDown)) {
+        // Mouse left the canvas, or hover or click outside canvas. A drag continues outside the canvas, but a hovering
+        // mouse (which uses the left button's touch number) is cancelled.
+        if (!platformData->mouseDown) {
+            glfm__cancelHover(display, 0, timestamp);
+        }
         return 0;
     }
-
-    // The mouse event handler targets EMSCRIPTEN_EVENT_TARGET_WINDOW so that dragging the mouse outside the canvas can
-    // be detected. If a mouse drag begins inside the canvas, the mouse release event is sent even if the mouse is
-    // released outside the canvas.
-    float canvasX, canvasY, canvasW, canvasH;
-    EM_ASM({
-        var rect = Module['canvas'].getBoundingClientRect();
-        setValue($0, rect.x, "float");
-        setValue($1, rect.y, "float");
-        setValue($2, rect.width, "float");
-        setValue($3, rect.height, "float");
-    }, &canvasX, &canvasY, &canvasW, &canvasH);
-    const float mouseX = (float)event->targetX - canvasX;
-    const float mouseY = (float)event->targetY - canvasY;
-    const bool mouseInside = mouseX >= 0 && mouseY >= 0 && mouseX < canvasW && mouseY < canvasH;
     if (!mouseInside && eventType == EMSCRIPTEN_EVENT_MOUSEDOWN) {
         // Mouse click outside canvas
         return 0;
     }
-    if (!mouseInside && eventType != EMSCRIPTEN_EVENT_MOUSEDOWN && !platformData->mouseDown) {
-        // Mouse hover or click outside canvas
-        return 0;
-    }
 
     GLFMTouchPhase touchPhase;
     switch (eventType) {
@@ -768,24 +1356,43 @@ static EM_BOOL glfm__mouseCallback(int eventType, const EmscriptenMouseEvent *ev
             platformData->mouseDown = false;
             break;
     }
-    bool handled = display->touchFunc(display, event->button, touchPhase,
-                                      platformData->scale * (double)mouseX,
-                                      platformData->scale * (double)mouseY);
+    bool handled = glfm__sendTouchEvent(display, button, touchPhase,
+                                        platformData->scale * (double)mouseX,
+                                        platformData->scale * (double)mouseY, timestamp);
     // Always return `false` when the event is `mouseDown` for iframe support. Returning `true` invokes
     // `preventDefault`, and invoking `preventDefault` on `mouseDown` events prevents `mouseMove` events outside the
     // iframe.
     return handled && eventType != EMSCRIPTEN_EVENT_MOUSEDOWN;
 }
 
-static EM_BOOL glfm__mouseWheelCallback(int eventType, const EmscriptenWheelEvent *wheelEvent, void *userData) {
-    (void)eventType;
+static EM_BOOL glfm__mouseCallback(int eventType, const EmscriptenMouseEvent *event, void *userData) {
     GLFMDisplay *display = userData;
+
+    // The mouse event handler targets EMSCRIPTEN_EVENT_TARGET_WINDOW so that dragging the mouse outside the canvas can
+    // be detected. If a mouse drag begins inside the canvas, the mouse release event is sent even if the mouse is
+    // released outside the canvas.
+    float canvasX, canvasY, canvasW, canvasH;
+    MAIN_THREAD_EM_ASM({
+        var rect = Module['canvas'].getBoundingClientRect();
+        setValue($0, rect.x, "float");
+        setValue($1, rect.y, "float");
+        setValue($2, rect.width, "float");
+        setValue($3, rect.height, "float");
+    }, &canvasX, &canvasY, &canvasW, &canvasH);
+    return glfm__handleMouseEvent(display, eventType, event->button, (float)event->targetX - canvasX,
+                                  (float)event->targetY - canvasY, canvasW, canvasH,
+                                  glfm__getEventTime(event->timestamp / 1000.0));
+}
+
+/// Handles a mouse wheel event. The position is relative to the canvas, in CSS pixels.
+static EM_BOOL glfm__handleMouseWheelEvent(GLFMDisplay *display, double x, double y, unsigned long deltaMode,
+                                           double deltaX, double deltaY, double deltaZ) {
     if (!display->mouseWheelFunc) {
         return 0;
     }
     GLFMPlatformData *platformData = display->platformData;
     GLFMMouseWheelDeltaType deltaType;
-    switch (wheelEvent->deltaMode) {
+    switch (deltaMode) {
         case DOM_DELTA_PIXEL: default:
             deltaType = GLFMMouseWheelDeltaPixel;
             break;
@@ -796,17 +1403,23 @@ static EM_BOOL glfm__mouseWheelCallback(int eventType, const EmscriptenWheelEven
             deltaType = GLFMMouseWheelDeltaPage;
             break;
     }
-    return display->mouseWheelFunc(display,
-                                   platformData->scale * (double)wheelEvent->mouse.targetX,
-                                   platformData->scale * (double)wheelEvent->mouse.targetY,
-                                   deltaType, wheelEvent->deltaX, wheelEvent->deltaY, wheelEvent->deltaZ);
+    return display->mouseWheelFunc(display, platformData->scale * x, platformData->scale * y,
+                                   deltaType, deltaX, deltaY, deltaZ);
 }
 
-static int glfm__getTouchIdentifier(GLFMPlatformData *platformData, const EmscriptenTouchPoint *touch) {
+static EM_BOOL glfm__mouseWheelCallback(int eventType, const EmscriptenWheelEvent *wheelEvent, void *userData) {
+    (void)eventType;
+    GLFMDisplay *display = userData;
+    return glfm__handleMouseWheelEvent(display, (double)wheelEvent->mouse.targetX, (double)wheelEvent->mouse.targetY,
+                                       wheelEvent->deltaMode, wheelEvent->deltaX, wheelEvent->deltaY,
+                                       wheelEvent->deltaZ);
+}
+
+static int glfm__getTouchIdentifier(GLFMPlatformData *platformData, long touchIdentifier) {
     int firstNullIndex = -1;
     int index = -1;
     for (int i = 0; i < GLFM_MAX_ACTIVE_TOUCHES; i++) {
-        if (platformData->activeTouches[i].identifier == touch->identifier &&
+        if (platformData->activeTouches[i].identifier == touchIdentifier &&
             platformData->activeTouches[i].active) {
             index = i;
             break;
@@ -821,81 +1434,453 @@ static int glfm__getTouchIdentifier(GLFMPlatformData *platformData, const Emscri
             return -1;
         }
         index = firstNullIndex;
-        platformData->activeTouches[index].identifier = touch->identifier;
+        platformData->activeTouches[index].identifier = touchIdentifier;
         platformData->activeTouches[index].active = true;
     }
     return index;
 }
 
-static EM_BOOL glfm__touchCallback(int eventType, const EmscriptenTouchEvent *event, void *userData) {
-    GLFMDisplay *display = userData;
-    if (!display->touchFunc) {
-        return 0;
-    }
-    GLFMPlatformData *platformData = display->platformData;
-    GLFMTouchPhase touchPhase;
+static GLFMTouchPhase glfm__getTouchPhase(int eventType) {
     switch (eventType) {
         case EMSCRIPTEN_EVENT_TOUCHSTART:
-            touchPhase = GLFMTouchPhaseBegan;
-            break;
+            return GLFMTouchPhaseBegan;
 
         case EMSCRIPTEN_EVENT_TOUCHMOVE:
-            touchPhase = GLFMTouchPhaseMoved;
-            break;
+            return GLFMTouchPhaseMoved;
 
         case EMSCRIPTEN_EVENT_TOUCHEND:
-            touchPhase = GLFMTouchPhaseEnded;
-            break;
+            return GLFMTouchPhaseEnded;
 
         case EMSCRIPTEN_EVENT_TOUCHCANCEL:
         default:
-            touchPhase = GLFMTouchPhaseCancelled;
-            break;
+            return GLFMTouchPhaseCancelled;
+    }
+}
+
+/// Handles a changed touch point. The position is relative to the canvas, in CSS pixels. The timestamp is in the
+/// ``glfmGetTime`` timebase.
+static EM_BOOL glfm__handleTouchPoint(GLFMDisplay *display, GLFMTouchPhase touchPhase, long touchIdentifier,
+                                      double targetX, double targetY, double timestamp) {
+    GLFMPlatformData *platformData = display->platformData;
+    EM_BOOL handled = 0;
+    int identifier = glfm__getTouchIdentifier(platformData, touchIdentifier);
+    if (identifier >= 0) {
+        if ((platformData->multitouchEnabled || identifier == 0)) {
+            handled = glfm__sendTouchEvent(display, identifier, touchPhase,
+                                           platformData->scale * targetX, platformData->scale * targetY, timestamp);
+        }
+
+        if (touchPhase == GLFMTouchPhaseEnded || touchPhase == GLFMTouchPhaseCancelled) {
+            platformData->activeTouches[identifier].active = false;
+        }
     }
+    return handled;
+}
 
+static EM_BOOL glfm__touchCallback(int eventType, const EmscriptenTouchEvent *event, void *userData) {
+    GLFMDisplay *display = userData;
+    const GLFMTouchPhase touchPhase = glfm__getTouchPhase(eventType);
+    const double timestamp = glfm__getEventTime(event->timestamp / 1000.0);
     int handled = 0;
     for (int i = 0; i < event->numTouches; i++) {
         const EmscriptenTouchPoint *touch = &event->touches[i];
         if (touch->isChanged) {
-            int identifier = glfm__getTouchIdentifier(platformData, touch);
-            if (identifier >= 0) {
-                if ((platformData->multitouchEnabled || identifier == 0)) {
-                    handled |= display->touchFunc(display, identifier, touchPhase,
-                                                  platformData->scale * (double)touch->targetX,
-                                                  platformData->scale * (double)touch->targetY);
-                }
+            handled |= glfm__handleTouchPoint(display, touchPhase, touch->identifier,
+                                              (double)touch->targetX, (double)touch->targetY, timestamp);
+        }
+    }
+    return handled;
+}
+
+// MARK: - Input batching
 
-                if (touchPhase == GLFMTouchPhaseEnded || touchPhase == GLFMTouchPhaseCancelled) {
-                    platformData->activeTouches[identifier].active = false;
+#if GLFM_FEATURE_KEYBOARD
+#  define GLFM_BATCHED_KEY_REPEAT (1 << 8)
+#endif
+
+// Groups of input listeners, added only while the app has a function for them or tracks input state. See
+// glfm__inputFuncUpdated.
+#define GLFM_INPUT_LISTENERS_TOUCH (1 << 0)
+#define GLFM_INPUT_LISTENERS_WHEEL (1 << 1)
+#define GLFM_INPUT_LISTENERS_KEY (1 << 2)
+
+// Event types written by the JavaScript listeners, by index. Must match the order in
+// glfm__setBatchedInputListeners.
+static const int GLFM_BATCHED_INPUT_EVENT_TYPES[] = {
+    EMSCRIPTEN_EVENT_TOUCHSTART, EMSCRIPTEN_EVENT_TOUCHEND, EMSCRIPTEN_EVENT_TOUCHMOVE, EMSCRIPTEN_EVENT_TOUCHCANCEL,
+    EMSCRIPTEN_EVENT_MOUSEDOWN, EMSCRIPTEN_EVENT_MOUSEUP, EMSCRIPTEN_EVENT_MOUSEMOVE, EMSCRIPTEN_EVENT_WHEEL,
+    EMSCRIPTEN_EVENT_KEYDOWN, EMSCRIPTEN_EVENT_KEYUP, EMSCRIPTEN_EVENT_MOUSELEAVE,
+};
+
+/// Sets which of the JavaScript listeners that write input events into the input ring are added (a mask of
+/// GLFM_INPUT_LISTENERS_* flags). These are used instead of the emscripten_set_*_callback listeners when input batching
+/// is enabled. The listeners don't call into wasm. The `handledListeners` are the groups the app has a function for.
+static void glfm__setBatchedInputListeners(GLFMDisplay *display, int listeners, int handledListeners) {
+    GLFMPlatformData *platformData = display->platformData;
+    MAIN_THREAD_EM_ASM({
+        var input = Module['glfmInput'];
+        if (!input) {
+            if ($0 == 0) {
+                return;
+            }
+            var ring = $1;
+            var ringSize = $2;
+            var recordSize = $3;
+            var writeCountIndex = $4 >> 2;
+            var readCountIndex = $5 >> 2;
+            var codeOffset = $6;
+            var keyOffset = $7;
+            var touchListeners = $8;
+            var wheelListeners = $9;
+            var keyListeners = $10;
+            var overflowedIndex = $12 >> 2;
+            var reserved = $13;
+            // The index in GLFM_BATCHED_INPUT_EVENT_TYPES
+            var types = {
+                touchstart: 0, touchend: 1, touchmove: 2, touchcancel: 3, mousedown: 4, mouseup: 5, mousemove: 6,
+                wheel: 7, keydown: 8, keyup: 9, mouseleave: 10
+            };
+            var canvas = Module['canvas'];
+            input = Module['glfmInput'] = { mask: 0, handled: 0, listeners: [] };
+
+            // Returns the address of the next record, or 0 if the ring is full. Moves (and wheel events) are dropped
+            // early to leave room for other events. If another event is dropped, the input state is reset when the
+            // ring is read.
+            var nextRecord = function(event, type, flags) {
+                var droppable = (type == types.touchmove || type == types.mousemove || type == types.wheel);
+                var writeCount = Atomics.load(HEAPU32, writeCountIndex);
+                var used = (writeCount - Atomics.load(HEAPU32, readCountIndex)) >>> 0;
+                if (used >= (droppable ? ringSize - reserved : ringSize)) {
+                    if (!droppable) {
+                        Atomics.store(HEAPU32, overflowedIndex, 1);
+                    }
+                    return 0;
+                }
+                var record = ring + (writeCount % ringSize) * recordSize;
+                HEAP32[record >> 2] = type;
+                HEAP32[(record >> 2) + 1] = flags;
+                HEAPF64[(record >> 3) + 1] = event.timeStamp / 1000;
+                return record;
+            };
+            var setValues = function(record, a, b, c, d, e, f) {
+                var index = (record >> 3) + 2;
+                HEAPF64[index + 0] = a;
+                HEAPF64[index + 1] = b;
+                HEAPF64[index + 2] = c;
+                HEAPF64[index + 3] = d;
+                HEAPF64[index + 4] = e;
+                HEAPF64[index + 5] = f;
+            };
+            var commitRecord = function() {
+                Atomics.add(HEAPU32, writeCountIndex, 1);
+            };
+
+            // If the app has a function for the event, the default action is prevented like it is when the app handles
+            // the event. Otherwise, the event is only recorded for the input state.
+            var onTouch = function(event) {
+                var rect = canvas.getBoundingClientRect();
+                var type = types[event.type];
+                for (var i = 0; i < event.changedTouches.length; i++) {
+                    var touch = event.changedTouches[i];
+                    var record = nextRecord(event, type, 0);
+                    if (record) {
+                        setValues(record, touch.identifier, touch.clientX - rect.left, touch.clientY - rect.top,
+                                  0, 0, 0);
+                        commitRecord();
+                    }
                 }
+                if (input.handled & touchListeners) {
+                    event.preventDefault();
+                }
+            };
+            // Mouse listeners are on the window so that dragging outside the canvas can be detected.
+            var onMouse = function(event) {
+                var rect = canvas.getBoundingClientRect();
+                var record = nextRecord(event, types[event.type], event.button);
+                if (record) {
+                    setValues(record, event.clientX - rect.left, event.clientY - rect.top, rect.width, rect.height,
+                              0, 0);
+                    commitRecord();
+                }
+            };
+            var onWheel = function(event) {
+                var rect = canvas.getBoundingClientRect();
+                var record = nextRecord(event, types[event.type], event.deltaMode);
+                if (record) {
+                    setValues(record, event.clientX - rect.left, event.clientY - rect.top,
+                              event.deltaX, event.deltaY, event.deltaZ, 0);
+                    commitRecord();
+                }
+                event.preventDefault();
+            };
+            var onKey = function(event) {
+                var flags = ((event.shiftKey ? 1 : 0) | (event.ctrlKey ? 2 : 0) | (event.altKey ? 4 : 0) |
+                             (event.metaKey ? 8 : 0) | (event.repeat ? 256 : 0));
+                var record = nextRecord(event, types[event.type], flags);
+                if (record) {
+                    stringToUTF8(event.code || '', record + codeOffset, 32);
+                    // A truncated key value is never a single character, so it is ignored for text input.
+                    stringToUTF8(event.key || '', record + keyOffset, 32);
+                    commitRecord();
+                }
+                if ((input.handled & keyListeners) && !event.ctrlKey && !event.metaKey) {
+                    event.preventDefault();
+                }
+            };
+
+            var touchOptions = { passive: false };
+            input.listeners = [
+                [touchListeners, canvas, 'touchstart', onTouch, touchOptions],
+                [touchListeners, canvas, 'touchend', onTouch, touchOptions],
+                [touchListeners, canvas, 'touchmove', onTouch, touchOptions],
+                [touchListeners, canvas, 'touchcancel', onTouch, touchOptions],
+                [touchListeners, window, 'mousedown', onMouse, false],
+                [touchListeners, window, 'mouseup', onMouse, false],
+                [touchListeners, window, 'mousemove', onMouse, false],
+                [touchListeners, canvas, 'mouseleave', onMouse, false],
+                [wheelListeners, canvas, 'wheel', onWheel, touchOptions],
+                [keyListeners, window, 'keydown', onKey, false],
+                [keyListeners, window, 'keyup', onKey, false]
+            ];
+        }
+        var mask = $0;
+        input.listeners.forEach(function(listener) {
+            var wasAdded = (input.mask & listener[0]) != 0;
+            var add = (mask & listener[0]) != 0;
+            if (add && !wasAdded) {
+                listener[1].addEventListener(listener[2], listener[3], listener[4]);
+            } else if (!add && wasAdded) {
+                listener[1].removeEventListener(listener[2], listener[3], listener[4]);
             }
+        });
+        input.mask = mask;
+        input.handled = $11;
+    }, listeners, platformData->inputRing, GLFM_INPUT_RING_SIZE, sizeof(GLFMBatchedInputEvent),
+       &platformData->inputRingWriteCount, &platformData->inputRingReadCount,
+       offsetof(GLFMBatchedInputEvent, code), offsetof(GLFMBatchedInputEvent, key),
+       GLFM_INPUT_LISTENERS_TOUCH, GLFM_INPUT_LISTENERS_WHEEL, GLFM_INPUT_LISTENERS_KEY, handledListeners,
+       &platformData->inputRingOverflowed, GLFM_INPUT_RING_RESERVED);
+}
+
+#if GLFM_FEATURE_KEYBOARD
+
+static void glfm__handleBatchedKeyEvent(GLFMDisplay *display, int eventType, const GLFMBatchedInputEvent *record) {
+    EmscriptenKeyboardEvent event = { 0 };
+    event.shiftKey = (record->flags & GLFMKeyModifierShift) != 0;
+    event.ctrlKey = (record->flags & GLFMKeyModifierControl) != 0;
+    event.altKey = (record->flags & GLFMKeyModifierAlt) != 0;
+    event.metaKey = (record->flags & GLFMKeyModifierMeta) != 0;
+    event.repeat = (record->flags & GLFM_BATCHED_KEY_REPEAT) != 0;
+    memcpy(event.code, record->code, sizeof(event.code));
+    memcpy(event.key, record->key, sizeof(event.key));
+    event.code[sizeof(event.code) - 1] = '\0';
+    event.key[sizeof(event.key) - 1] = '\0';
+    glfm__keyCallback(eventType, &event, display);
+}
+
+#endif
+
+/// Cancels the tracked touches, and releases the mouse buttons and keys. Called when input events were dropped, so
+/// that no touch, button, or key is left down.
+static void glfm__resetInputState(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    const double timestamp = glfmGetTime();
+    for (int i = 0; i < GLFM_MAX_TRACKED_TOUCHES; i++) {
+        glfm__cancelTouch(display, i, timestamp);
+    }
+    platformData->mouseDown = false;
+    glfm__clearActiveTouches(platformData);
+    glfm__clearKeysDown(display);
+}
+
+static void glfm__drainInputRing(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    const uint32_t writeCount = GLFM_ATOMIC_LOAD(&platformData->inputRingWriteCount);
+    uint32_t readCount = platformData->inputRingReadCount;
+    for (; readCount != writeCount; readCount++) {
+        const GLFMBatchedInputEvent *record = &platformData->inputRing[readCount % GLFM_INPUT_RING_SIZE];
+        const double *values = record->values;
+        const int typeCount = (int)(sizeof(GLFM_BATCHED_INPUT_EVENT_TYPES) / sizeof(*GLFM_BATCHED_INPUT_EVENT_TYPES));
+        if (record->type < 0 || record->type >= typeCount) {
+            continue;
+        }
+        const int eventType = GLFM_BATCHED_INPUT_EVENT_TYPES[record->type];
+        switch (eventType) {
+            case EMSCRIPTEN_EVENT_TOUCHSTART:
+            case EMSCRIPTEN_EVENT_TOUCHEND:
+            case EMSCRIPTEN_EVENT_TOUCHMOVE:
+            case EMSCRIPTEN_EVENT_TOUCHCANCEL:
+                glfm__handleTouchPoint(display, glfm__getTouchPhase(eventType), (long)values[0],
+                                       values[1], values[2], glfm__getEventTime(record->timestamp));
+                break;
+            case EMSCRIPTEN_EVENT_MOUSEDOWN:
+            case EMSCRIPTEN_EVENT_MOUSEUP:
+            case EMSCRIPTEN_EVENT_MOUSEMOVE:
+            case EMSCRIPTEN_EVENT_MOUSELEAVE:
+                glfm__handleMouseEvent(display, eventType, record->flags, (float)values[0], (float)values[1],
+                                       (float)values[2], (float)values[3], glfm__getEventTime(record->timestamp));
+                break;
+            case EMSCRIPTEN_EVENT_WHEEL:
+                glfm__handleMouseWheelEvent(display, values[0], values[1], (unsigned long)record->flags,
+                                            values[2], values[3], values[4]);
+                break;
+#if GLFM_FEATURE_KEYBOARD
+            case EMSCRIPTEN_EVENT_KEYDOWN:
+            case EMSCRIPTEN_EVENT_KEYUP:
+                glfm__handleBatchedKeyEvent(display, eventType, record);
+                break;
+#endif
+            default:
+                break;
         }
     }
-    return handled;
+    // The ring stays full until the read count is stored, so no events are written after the dropped one until then
+    if (GLFM_ATOMIC_EXCHANGE(&platformData->inputRingOverflowed, 0)) {
+        glfm__resetInputState(display);
+    }
+    GLFM_ATOMIC_STORE(&platformData->inputRingReadCount, readCount);
+}
+
+/// Skips the unread events in the input ring, and resets the input state they would have changed.
+static void glfm__discardInputRing(GLFMDisplay *display) {
+    GLFMPlatformData *platformData = display->platformData;
+    if (GLFM_ATOMIC_LOAD(&platformData->inputRingWriteCount) == platformData->inputRingReadCount &&
+        !GLFM_ATOMIC_LOAD(&platformData->inputRingOverflowed)) {
+        return;
+    }
+    GLFM_ATOMIC_EXCHANGE(&platformData->inputRingOverflowed, 0);
+    glfm__resetInputState(display);
+    GLFM_ATOMIC_STORE(&platformData->inputRingReadCount, GLFM_ATOMIC_LOAD(&platformData->inputRingWriteCount));
+}
+
+/// Sets which emscripten_set_*_callback input listeners are added (a mask of GLFM_INPUT_LISTENERS_* flags).
+static void glfm__setInputCallbacks(GLFMDisplay *display, int listeners) {
+    const char *target = GLFM_CANVAS_TARGET;
+    const char *window = EMSCRIPTEN_EVENT_TARGET_WINDOW;
+    const bool touch = (listeners & GLFM_INPUT_LISTENERS_TOUCH) != 0;
+    const bool wheel = (listeners & GLFM_INPUT_LISTENERS_WHEEL) != 0;
+    emscripten_set_touchstart_callback(target, display, 1, touch ? glfm__touchCallback : NULL);
+    emscripten_set_touchend_callback(target, display, 1, touch ? glfm__touchCallback : NULL);
+    emscripten_set_touchmove_callback(target, display, 1, touch ? glfm__touchCallback : NULL);
+    emscripten_set_touchcancel_callback(target, display, 1, touch ? glfm__touchCallback : NULL);
+    emscripten_set_mousedown_callback(window, display, 1, touch ? glfm__mouseCallback : NULL);
+    emscripten_set_mouseup_callback(window, display, 1, touch ? glfm__mouseCallback : NULL);
+    emscripten_set_mousemove_callback(window, display, 1, touch ? glfm__mouseCallback : NULL);
+    emscripten_set_mouseleave_callback(target, display, 1, touch ? glfm__mouseCallback : NULL);
+    emscripten_set_wheel_callback(target, display, 1, wheel ? glfm__mouseWheelCallback : NULL);
+#if GLFM_FEATURE_KEYBOARD
+    const bool key = (listeners & GLFM_INPUT_LISTENERS_KEY) != 0;
+    emscripten_set_keydown_callback(window, display, 1, key ? glfm__keyCallback : NULL);
+    emscripten_set_keyup_callback(window, display, 1, key ? glfm__keyCallback : NULL);
+#endif
+}
+
+/// Adds and removes input listeners so that the browser only sends events the app has a function for.
+static void glfm__inputFuncUpdated(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    GLFMPlatformData *platformData = display->platformData;
+    if (!platformData || !platformData->inputListenersReady) {
+        return;
+    }
+    int handledListeners = 0;
+    if (display->touchFunc) {
+        handledListeners |= GLFM_INPUT_LISTENERS_TOUCH;
+    }
+    if (display->mouseWheelFunc) {
+        handledListeners |= GLFM_INPUT_LISTENERS_WHEEL;
+    }
+    if (GLFM_FEATURE_KEYBOARD && (display->keyFunc || display->charFunc)) {
+        handledListeners |= GLFM_INPUT_LISTENERS_KEY;
+    }
+    int listeners = handledListeners;
+    if (display->inputStateTrackingEnabled) {
+        // For glfmGetTouchState, glfmGetPredictedTouch, and glfmIsKeyDown
+        listeners |= GLFM_INPUT_LISTENERS_TOUCH;
+        if (GLFM_FEATURE_KEYBOARD) {
+            listeners |= GLFM_INPUT_LISTENERS_KEY;
+        }
+    }
+    // The app thread can't add DOM event listeners, so events are always batched with GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS.
+    const bool batched = display->inputBatchingEnabled || GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS;
+    const int batchedListeners = batched ? listeners : 0;
+    const int callbackListeners = batched ? 0 : listeners;
+    const int previousBatchedListeners = platformData->inputListenersBatched ? platformData->inputListeners : 0;
+    const int previousCallbackListeners = platformData->inputListenersBatched ? 0 : platformData->inputListeners;
+    if (batchedListeners != previousBatchedListeners ||
+        (batched && handledListeners != platformData->inputListenersHandled)) {
+        glfm__setBatchedInputListeners(display, batchedListeners, handledListeners);
+    }
+    if (callbackListeners != previousCallbackListeners) {
+        glfm__setInputCallbacks(display, callbackListeners);
+    }
+
+    // Events may be missed while listeners are removed, so reset the state they track
+    const int removedListeners = platformData->inputListeners & ~listeners;
+    if (removedListeners & GLFM_INPUT_LISTENERS_TOUCH) {
+        platformData->mouseDown = false;
+        glfm__clearActiveTouches(platformData);
+    }
+    if (removedListeners & GLFM_INPUT_LISTENERS_KEY) {
+        glfm__clearKeysDown(display);
+    }
+    platformData->inputListeners = listeners;
+    platformData->inputListenersHandled = handledListeners;
+    platformData->inputListenersBatched = batched;
 }
 
 // MARK: - main
 
-int main(void) {
+/// EmscriptenWebGLContextAttributes has no `desynchronized` attribute, so while requested, the `getContext` function
+/// of canvases on the current thread adds it.
+static void glfm__setDesynchronizedContextRequested(bool requested) {
+    EM_ASM({
+        var requested = ($0 != 0);
+        var patched = Module['glfmGetContextFunctions'];
+        if (requested && !patched) {
+            patched = Module['glfmGetContextFunctions'] = [];
+            [
+                (typeof HTMLCanvasElement !== 'undefined') ? HTMLCanvasElement.prototype : null,
+                (typeof OffscreenCanvas !== 'undefined') ? OffscreenCanvas.prototype : null
+            ].forEach(function(prototype) {
+                if (!prototype) {
+                    return;
+                }
+                var getContext = prototype.getContext;
+                prototype.getContext = function(contextType, contextAttributes) {
+                    var attributes = Object.assign({}, contextAttributes);
+                    attributes['desynchronized'] = true;
+                    return getContext.call(this, contextType, attributes);
+                };
+                patched.push([prototype, getContext]);
+            });
+        } else if (!requested && patched) {
+            patched.forEach(function(entry) {
+                entry[0].getContext = entry[1];
+            });
+            delete Module['glfmGetContextFunctions'];
+        }
+    }, requested);
+}
+
+static void glfm__startApp(void) {
     GLFMDisplay *glfmDisplay = calloc(1, sizeof(GLFMDisplay));
     GLFMPlatformData *platformData = calloc(1, sizeof(GLFMPlatformData));
     glfmDisplay->platformData = platformData;
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+    platformData->appThread = pthread_self();
+#endif
     glfmDisplay->supportedOrientations = GLFMInterfaceOrientationAll;
+    glfmDisplay->renderScale = 1.0;
     platformData->orientation = glfmGetInterfaceOrientation(glfmDisplay);
 
     // Main entry
     glfmMain(glfmDisplay);
 
     // Init resizable canvas
-    EM_ASM({
-        var canvas = Module['canvas'];
-        var devicePixelRatio = window.devicePixelRatio || 1;
-        canvas.width = canvas.clientWidth * devicePixelRatio;
-        canvas.height = canvas.clientHeight * devicePixelRatio;
-    });
-    platformData->width = glfm__getDisplayWidth(glfmDisplay);
-    platformData->height = glfm__getDisplayHeight(glfmDisplay);
-    platformData->scale = emscripten_get_device_pixel_ratio();
+    glfm__observeCanvasSize(glfmDisplay);
+    glfm__updateCanvasSize(glfmDisplay);
 
     // Create WebGL context
     EmscriptenWebGLContextAttributes attribs;
@@ -905,13 +1890,28 @@ int main(void) {
     attribs.stencil = glfmDisplay->stencilFormat != GLFMStencilFormatNone;
     attribs.antialias = glfmDisplay->multisample != GLFMMultisampleNone;
     attribs.premultipliedAlpha = 1;
-    attribs.preserveDrawingBuffer = 0;
-    attribs.powerPreference = EM_WEBGL_POWER_PREFERENCE_HIGH_PERFORMANCE;
-    attribs.failIfMajorPerformanceCaveat = 0;
+    attribs.preserveDrawingBuffer = glfmDisplay->swapBehavior == GLFMSwapBehaviorBufferPreserved;
+    switch (glfmDisplay->powerPreference) {
+        case GLFMPowerPreferenceLowPower:
+            attribs.powerPreference = EM_WEBGL_POWER_PREFERENCE_LOW_POWER;
+            break;
+        case GLFMPowerPreferencePlatformDefault:
+        case GLFMPowerPreferenceHighPerformance:
+        default:
+            attribs.powerPreference = EM_WEBGL_POWER_PREFERENCE_HIGH_PERFORMANCE;
+            break;
+    }
+    attribs.failIfMajorPerformanceCaveat = glfmDisplay->failIfMajorPerformanceCaveat;
     attribs.enableExtensionsByDefault = 0;
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+    attribs.proxyContextToMainThread = EMSCRIPTEN_WEBGL_CONTEXT_PROXY_DISALLOW;
+#endif
 
-    const char *webGLTarget = "#canvas";
+    const char *webGLTarget = GLFM_CANVAS_TARGET;
     EMSCRIPTEN_WEBGL_CONTEXT_HANDLE contextHandle = 0;
+    if (glfmDisplay->lowLatencyEnabled) {
+        glfm__setDesynchronizedContextRequested(true);
+    }
     if (glfmDisplay->preferredAPI >= GLFMRenderingAPIOpenGLES3) {
         // OpenGL ES 3.0 / WebGL 2.0
         attribs.majorVersion = 2;
@@ -930,34 +1930,32 @@ int main(void) {
             platformData->renderingAPI = GLFMRenderingAPIOpenGLES2;
         }
     }
+    if (glfmDisplay->lowLatencyEnabled) {
+        glfm__setDesynchronizedContextRequested(false);
+    }
     if (!contextHandle) {
         GLFM_LOG("Couldn't create GL context");
         glfm__reportSurfaceError(glfmDisplay, "Couldn't create GL context");
-        return 0;
+        return;
     }
 
     emscripten_webgl_make_context_current(contextHandle);
+    platformData->contextHandle = contextHandle;
+    platformData->drawingBufferPreserved = attribs.preserveDrawingBuffer != 0;
+    glfm__enableExtensions(glfmDisplay);
 
     if (glfmDisplay->surfaceCreatedFunc) {
         glfmDisplay->surfaceCreatedFunc(glfmDisplay, platformData->width, platformData->height);
     }
-    glfm__setVisibleAndFocused(glfmDisplay, true, true);
+    EmscriptenVisibilityChangeEvent visibilityStatus;
+    bool visible = (emscripten_get_visibility_status(&visibilityStatus) != EMSCRIPTEN_RESULT_SUCCESS ||
+                    !visibilityStatus.hidden);
+    glfm__setVisibleAndFocused(glfmDisplay, visible, true);
 
     // Setup callbacks
     emscripten_set_main_loop_arg(glfm__mainLoopFunc, glfmDisplay, 0, 0);
-    emscripten_set_touchstart_callback(webGLTarget, glfmDisplay, 1, glfm__touchCallback);
-    emscripten_set_touchend_callback(webGLTarget, glfmDisplay, 1, glfm__touchCallback);
-    emscripten_set_touchmove_callback(webGLTarget, glfmDisplay, 1, glfm__touchCallback);
-    emscripten_set_touchcancel_callback(webGLTarget, glfmDisplay, 1, glfm__touchCallback);
-    emscripten_set_mousedown_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__mouseCallback);
-    emscripten_set_mouseup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__mouseCallback);
-    emscripten_set_mousemove_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__mouseCallback);
-    emscripten_set_wheel_callback(webGLTarget, glfmDisplay, 1, glfm__mouseWheelCallback);
-    //emscripten_set_click_callback(webGLTarget, glfmDisplay, 1, glfm__mouseCallback);
-    //emscripten_set_dblclick_callback(webGLTarget, glfmDisplay, 1, glfm__mouseCallback);
-    emscripten_set_keypress_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__keyCallback);
-    emscripten_set_keydown_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__keyCallback);
-    emscripten_set_keyup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__keyCallback);
+    platformData->mainLoopStarted = true;
+    glfm__updateMainLoop(glfmDisplay);
     emscripten_set_webglcontextlost_callback(webGLTarget, glfmDisplay, 1, glfm__webGLContextCallback);
     emscripten_set_webglcontextrestored_callback(webGLTarget, glfmDisplay, 1, glfm__webGLContextCallback);
     emscripten_set_visibilitychange_callback(glfmDisplay, 1, glfm__visibilityChangeCallback);
@@ -965,6 +1963,39 @@ int main(void) {
     emscripten_set_blur_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, glfmDisplay, 1, glfm__focusCallback);
     emscripten_set_beforeunload_callback(glfmDisplay, glfm__beforeUnloadCallback);
     emscripten_set_deviceorientation_callback(glfmDisplay, 1, glfm__orientationChangeCallback);
+    platformData->inputListenersReady = true;
+    glfm__inputFuncUpdated(glfmDisplay);
+}
+
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+
+static void *glfm__appThreadFunc(void *arg) {
+    (void)arg;
+    glfm__startApp();
+    // Keep the thread alive to run the main loop and the proxied event callbacks
+    emscripten_exit_with_live_runtime();
+    return NULL;
+}
+
+#endif
+
+int main(void) {
+#if GLFM_EMSCRIPTEN_OFFSCREEN_CANVAS
+    // Run the app on a thread that owns the canvas. The browser's main thread only runs the DOM event listeners, which
+    // write events into the input and sensor rings.
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    emscripten_pthread_attr_settransferredcanvases(&attr, GLFM_CANVAS_TARGET);
+    pthread_t appThread;
+    int result = pthread_create(&appThread, &attr, glfm__appThreadFunc, NULL);
+    pthread_attr_destroy(&attr);
+    if (result != 0) {
+        GLFM_LOG("Couldn't create app thread");
+        return 1;
+    }
+#else
+    glfm__startApp();
+#endif
     return 0;
 }
 
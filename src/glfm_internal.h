@@ -5,7 +5,9 @@
 #define GLFM_INTERNAL_H
 
 #include "glfm.h"
+#include <math.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,6 +17,22 @@ extern "C" {
 #endif
 
 #define GLFM_NUM_SENSORS 4
+#define GLFM_SENSOR_HISTORY_SIZE 32
+#define GLFM_SENSOR_HISTORY_MAX_EXTRAPOLATION 0.1
+#define GLFM_MAX_TRACKED_TOUCHES 10
+#define GLFM_TOUCH_HISTORY_SIZE 8
+#define GLFM_TOUCH_PREDICTION_WINDOW 0.1
+#define GLFM_TOUCH_PREDICTION_MAX_TIME 0.05
+#define GLFM_KEY_STATE_WORDS 8
+#define GLFM_RESOURCE_CREATE_BUDGET 0.004 // Seconds per frame
+
+#define GLFM_RENDER_SCALE_MIN 0.25
+#define GLFM_AUTO_RENDER_SCALE_MIN 0.5
+#define GLFM_AUTO_RENDER_SCALE_STEP 0.05
+#define GLFM_AUTO_RENDER_SCALE_COOLDOWN_FRAMES 30
+#define GLFM_AUTO_RENDER_SCALE_UPSCALE_MIN_FRAMES 120
+#define GLFM_AUTO_RENDER_SCALE_UPSCALE_MAX_FRAMES 1200
+#define GLFM_AUTO_RENDER_SCALE_MAX_FRAME_DURATION 0.25
 
 #if defined(__GNUC__) && __STDC_VERSION__ >= 199901
 #define GLFM_IGNORE_DEPRECATIONS_START \
@@ -27,6 +45,41 @@ extern "C" {
 #define GLFM_IGNORE_DEPRECATIONS_END
 #endif
 
+typedef struct {
+    double timestamp;
+    double x;
+    double y;
+} GLFMTouchSample;
+
+/// A touch move held until the next frame. See ``glfmSetTouchCoalescingEnabled``.
+typedef struct {
+    double x;
+    double y;
+    GLFMTouchPhase phase;
+    bool pending;
+} GLFMCoalescedTouch;
+
+/// Recent positions of a touch, for prediction and polling. A ring buffer, newest at `index - 1`.
+typedef struct {
+    GLFMTouchSample samples[GLFM_TOUCH_HISTORY_SIZE];
+    int index;
+    int count;
+    GLFMTouchPhase phase;
+    bool active;
+    /// Set when the touch ends or is cancelled, so that it is polled with its final phase until the frame is drawn.
+    bool ended;
+} GLFMTouchHistory;
+
+/// A resource added with ``glfmAddResource``.
+typedef struct {
+    int id;
+    GLFMResourceCreateFunc createFunc;
+    void *data;
+    size_t size;
+    void *userData;
+    bool ready;
+} GLFMResource;
+
 struct GLFMDisplay {
     // Config
     GLFMRenderingAPI preferredAPI;
@@ -37,6 +90,24 @@ struct GLFMDisplay {
     GLFMInterfaceOrientation supportedOrientations;
     GLFMUserInterfaceChrome uiChrome;
     GLFMSwapBehavior swapBehavior;
+    GLFMPowerPreference powerPreference;
+    bool failIfMajorPerformanceCaveat;
+    bool lowLatencyEnabled;
+    char **enabledExtensions;
+    int enabledExtensionCount;
+    bool enabledExtensionsSet;
+    bool contextPreservationEnabled;
+    bool depthStencilInvalidationEnabled;
+    bool preRotationEnabled;
+    double renderScale;
+    bool renderScaleAutomatic;
+    GLFMSensorFusionMode sensorFusionMode;
+    bool touchCoalescingEnabled;
+    bool inputBatchingEnabled;
+    bool inputStateTrackingEnabled;
+    /// Set when the app calls ``glfmSetInputStateTrackingEnabled``, so that polling doesn't enable tracking.
+    bool inputStateTrackingSet;
+    double hiddenFrameRate;
 
     // Callbacks
     GLFM_IGNORE_DEPRECATIONS_START
@@ -58,16 +129,64 @@ struct GLFMDisplay {
     GLFMMemoryWarningFunc lowMemoryFunc;
     GLFMAppFocusFunc focusFunc;
     GLFMSensorFunc sensorFuncs[GLFM_NUM_SENSORS];
+    GLFMSensorBatchFunc sensorBatchFuncs[GLFM_NUM_SENSORS];
+    double sensorRates[GLFM_NUM_SENSORS];
+    double sensorMaxLatencies[GLFM_NUM_SENSORS];
+
+    // Sensor history (ring buffers, newest at sensorHistoryIndex - 1)
+    GLFMSensorEvent sensorHistory[GLFM_NUM_SENSORS][GLFM_SENSOR_HISTORY_SIZE];
+    int sensorHistoryIndex[GLFM_NUM_SENSORS];
+    int sensorHistoryCount[GLFM_NUM_SENSORS];
+
+    // Touch history and coalesced touches
+    GLFMTouchHistory touchHistory[GLFM_MAX_TRACKED_TOUCHES];
+    GLFMCoalescedTouch coalescedTouches[GLFM_MAX_TRACKED_TOUCHES];
+
+    // Keys currently down, one bit per GLFMKeyCode
+    uint32_t keysDown[GLFM_KEY_STATE_WORDS];
+
+    // Latest rotation from sensor fusion (set by the platform when the rotation sensor is computed from raw sensors)
+    double sensorFusionQuaternion[4];
+    bool sensorFusionQuaternionValid;
+
+    // Automatic render scale state
+    struct {
+        double scale;
+        double averageFrameDuration;
+        int cooldownFrames;
+        int stableFrames;
+        int upscaleDelayFrames;
+    } autoRenderScale;
 
     // External data
     void *userData;
     void *platformData;
+
+    // Space-separated list of supported OpenGL extensions, cached on first use. See glfmIsExtensionSupported.
+    char *supportedExtensions;
+
+    // Resources created by GLFM, in the order they were added. See glfmAddResource.
+    GLFMResource *resources;
+    int resourceCount;
+    int resourceCapacity;
+    int pendingResourceCount;
+    int lastResourceID;
 };
 
 // MARK: - Notification functions
 
 static void glfm__displayChromeUpdated(GLFMDisplay *display);
 static void glfm__sensorFuncUpdated(GLFMDisplay *display);
+static void glfm__inputFuncUpdated(GLFMDisplay *display);
+static void glfm__hiddenFrameRateUpdated(GLFMDisplay *display);
+
+// MARK: - Platform functions
+
+/// Converts a time from ``glfmGetTime`` to the timebase of `GLFMSensorEvent` timestamps.
+static double glfm__getSensorTimestamp(double time);
+
+/// Returns a newly allocated, space-separated list of supported OpenGL extensions, or `NULL` if there is no surface.
+static char *glfm__copySupportedExtensions(GLFMDisplay *display);
 
 // MARK: - Setters
 
@@ -226,6 +345,7 @@ GLFMTouchFunc glfmSetTouchFunc(GLFMDisplay *display, GLFMTouchFunc touchFunc) {
     if (display) {
         previous = display->touchFunc;
         display->touchFunc = touchFunc;
+        glfm__inputFuncUpdated(display);
     }
     return previous;
 }
@@ -235,6 +355,7 @@ GLFMKeyFunc glfmSetKeyFunc(GLFMDisplay *display, GLFMKeyFunc keyFunc) {
     if (display) {
         previous = display->keyFunc;
         display->keyFunc = keyFunc;
+        glfm__inputFuncUpdated(display);
     }
     return previous;
 }
@@ -244,6 +365,7 @@ GLFMCharFunc glfmSetCharFunc(GLFMDisplay *display, GLFMCharFunc charFunc) {
     if (display) {
         previous = display->charFunc;
         display->charFunc = charFunc;
+        glfm__inputFuncUpdated(display);
     }
     return previous;
 }
@@ -253,6 +375,7 @@ GLFMMouseWheelFunc glfmSetMouseWheelFunc(GLFMDisplay *display, GLFMMouseWheelFun
     if (display) {
         previous = display->mouseWheelFunc;
         display->mouseWheelFunc = mouseWheelFunc;
+        glfm__inputFuncUpdated(display);
     }
     return previous;
 }
@@ -270,6 +393,28 @@ GLFMSensorFunc glfmSetSensorFunc(GLFMDisplay *display, GLFMSensor sensor, GLFMSe
     return previous;
 }
 
+GLFMSensorBatchFunc glfmSetSensorBatchFunc(GLFMDisplay *display, GLFMSensor sensor, GLFMSensorBatchFunc batchFunc) {
+    GLFMSensorBatchFunc previous = NULL;
+    int index = (int)sensor;
+    if (display && index >= 0 && index < GLFM_NUM_SENSORS) {
+        previous = display->sensorBatchFuncs[index];
+        if (batchFunc != previous) {
+            display->sensorBatchFuncs[index] = batchFunc;
+            glfm__sensorFuncUpdated(display);
+        }
+    }
+    return previous;
+}
+
+void glfmSetSensorRate(GLFMDisplay *display, GLFMSensor sensor, double hz, double maxLatency) {
+    int index = (int)sensor;
+    if (display && index >= 0 && index < GLFM_NUM_SENSORS) {
+        display->sensorRates[index] = hz > 0.0 ? hz : 0.0;
+        display->sensorMaxLatencies[index] = maxLatency > 0.0 ? maxLatency : 0.0;
+        glfm__sensorFuncUpdated(display);
+    }
+}
+
 GLFMMemoryWarningFunc glfmSetMemoryWarningFunc(GLFMDisplay *display, GLFMMemoryWarningFunc lowMemoryFunc) {
     GLFMMemoryWarningFunc previous = NULL;
     if (display) {
@@ -302,6 +447,185 @@ GLFMSwapBehavior glfmGetSwapBehavior(const GLFMDisplay *display) {
     return GLFMSwapBehaviorPlatformDefault;
 }
 
+void glfmSetPowerPreference(GLFMDisplay *display, GLFMPowerPreference powerPreference) {
+    if (display) {
+        display->powerPreference = powerPreference;
+    }
+}
+
+GLFMPowerPreference glfmGetPowerPreference(const GLFMDisplay *display) {
+    return display ? display->powerPreference : GLFMPowerPreferencePlatformDefault;
+}
+
+void glfmSetFailIfMajorPerformanceCaveat(GLFMDisplay *display, bool fail) {
+    if (display) {
+        display->failIfMajorPerformanceCaveat = fail;
+    }
+}
+
+bool glfmGetFailIfMajorPerformanceCaveat(const GLFMDisplay *display) {
+    return display ? display->failIfMajorPerformanceCaveat : false;
+}
+
+void glfmSetLowLatencyEnabled(GLFMDisplay *display, bool enabled) {
+    if (display) {
+        display->lowLatencyEnabled = enabled;
+    }
+}
+
+bool glfmGetLowLatencyEnabled(const GLFMDisplay *display) {
+    return display ? display->lowLatencyEnabled : false;
+}
+
+void glfmSetEnabledExtensions(GLFMDisplay *display, const char *const *extensions, int count) {
+    if (!display) {
+        return;
+    }
+    for (int i = 0; i < display->enabledExtensionCount; i++) {
+        free(display->enabledExtensions[i]);
+    }
+    free(display->enabledExtensions);
+    display->enabledExtensions = NULL;
+    display->enabledExtensionCount = 0;
+    display->enabledExtensionsSet = true;
+    if (!extensions || count <= 0) {
+        return;
+    }
+    display->enabledExtensions = calloc((size_t)count, sizeof(char *));
+    if (!display->enabledExtensions) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        if (extensions[i]) {
+            char *extension = malloc(strlen(extensions[i]) + 1);
+            if (extension) {
+                strcpy(extension, extensions[i]);
+                display->enabledExtensions[display->enabledExtensionCount++] = extension;
+            }
+        }
+    }
+}
+
+void glfmSetContextPreservationEnabled(GLFMDisplay *display, bool enabled) {
+    if (display) {
+        display->contextPreservationEnabled = enabled;
+    }
+}
+
+bool glfmGetContextPreservationEnabled(const GLFMDisplay *display) {
+    return display ? display->contextPreservationEnabled : false;
+}
+
+void glfmSetDepthStencilInvalidationEnabled(GLFMDisplay *display, bool enabled) {
+    if (display) {
+        display->depthStencilInvalidationEnabled = enabled;
+    }
+}
+
+bool glfmGetDepthStencilInvalidationEnabled(const GLFMDisplay *display) {
+    return display ? display->depthStencilInvalidationEnabled : false;
+}
+
+void glfmSetPreRotationEnabled(GLFMDisplay *display, bool enabled) {
+    if (display) {
+        display->preRotationEnabled = enabled;
+    }
+}
+
+bool glfmGetPreRotationEnabled(const GLFMDisplay *display) {
+    return display ? display->preRotationEnabled : false;
+}
+
+static double glfm__getRenderScale(const GLFMDisplay *display);
+
+void glfmSetRenderScale(GLFMDisplay *display, double scale) {
+    if (display) {
+        if (scale < GLFM_RENDER_SCALE_MIN) {
+            scale = GLFM_RENDER_SCALE_MIN;
+        } else if (scale > 1.0) {
+            scale = 1.0;
+        }
+        display->renderScale = scale;
+        display->autoRenderScale.scale = scale;
+        display->autoRenderScale.averageFrameDuration = 0.0;
+        display->autoRenderScale.stableFrames = 0;
+    }
+}
+
+double glfmGetRenderScale(const GLFMDisplay *display) {
+    return glfm__getRenderScale(display);
+}
+
+void glfmSetAutomaticRenderScaleEnabled(GLFMDisplay *display, bool enabled) {
+    if (display && display->renderScaleAutomatic != enabled) {
+        display->renderScaleAutomatic = enabled;
+        display->autoRenderScale.scale = display->renderScale;
+        display->autoRenderScale.averageFrameDuration = 0.0;
+        display->autoRenderScale.cooldownFrames = 0;
+        display->autoRenderScale.stableFrames = 0;
+        display->autoRenderScale.upscaleDelayFrames = GLFM_AUTO_RENDER_SCALE_UPSCALE_MIN_FRAMES;
+    }
+}
+
+bool glfmGetAutomaticRenderScaleEnabled(const GLFMDisplay *display) {
+    return display ? display->renderScaleAutomatic : false;
+}
+
+void glfmSetHiddenFrameRate(GLFMDisplay *display, double framesPerSecond) {
+    if (framesPerSecond < 0.0) {
+        framesPerSecond = 0.0;
+    }
+    if (display && (display->hiddenFrameRate < framesPerSecond || display->hiddenFrameRate > framesPerSecond)) {
+        display->hiddenFrameRate = framesPerSecond;
+        glfm__hiddenFrameRateUpdated(display);
+    }
+}
+
+double glfmGetHiddenFrameRate(const GLFMDisplay *display) {
+    return display ? display->hiddenFrameRate : 0.0;
+}
+
+void glfmSetSensorFusionMode(GLFMDisplay *display, GLFMSensorFusionMode mode) {
+    if (display && display->sensorFusionMode != mode) {
+        display->sensorFusionMode = mode;
+        glfm__sensorFuncUpdated(display);
+    }
+}
+
+GLFMSensorFusionMode glfmGetSensorFusionMode(const GLFMDisplay *display) {
+    return display ? display->sensorFusionMode : GLFMSensorFusionModeAutomatic;
+}
+
+bool glfmGetTouchCoalescingEnabled(const GLFMDisplay *display) {
+    return display ? display->touchCoalescingEnabled : false;
+}
+
+void glfmSetInputBatchingEnabled(GLFMDisplay *display, bool enabled) {
+    if (display && display->inputBatchingEnabled != enabled) {
+        display->inputBatchingEnabled = enabled;
+        glfm__inputFuncUpdated(display);
+    }
+}
+
+bool glfmGetInputBatchingEnabled(const GLFMDisplay *display) {
+    return display ? display->inputBatchingEnabled : false;
+}
+
+void glfmSetInputStateTrackingEnabled(GLFMDisplay *display, bool enabled) {
+    if (!display) {
+        return;
+    }
+    display->inputStateTrackingSet = true;
+    if (display->inputStateTrackingEnabled != enabled) {
+        display->inputStateTrackingEnabled = enabled;
+        glfm__inputFuncUpdated(display);
+    }
+}
+
+bool glfmGetInputStateTrackingEnabled(const GLFMDisplay *display) {
+    return display ? display->inputStateTrackingEnabled : false;
+}
+
 // MARK: - Helper functions
 
 static void glfm__reportSurfaceError(GLFMDisplay *display, const char *errorMessage) {
@@ -310,6 +634,736 @@ static void glfm__reportSurfaceError(GLFMDisplay *display, const char *errorMess
     }
 }
 
+/// Records the touch for prediction and polling. The timestamp is when the touch occurred, in the ``glfmGetTime``
+/// timebase.
+static void glfm__recordTouch(GLFMDisplay *display, int touch, GLFMTouchPhase phase, double x, double y,
+                              double timestamp) {
+    if (touch >= 0 && touch < GLFM_MAX_TRACKED_TOUCHES) {
+        GLFMTouchHistory *history = &display->touchHistory[touch];
+        const bool ended = (phase == GLFMTouchPhaseEnded || phase == GLFMTouchPhaseCancelled);
+        if (ended) {
+            // Keep only the final position
+            history->active = false;
+            history->ended = true;
+            history->count = 0;
+        } else if (phase == GLFMTouchPhaseBegan || !history->active) {
+            history->active = true;
+            history->ended = false;
+            history->count = 0;
+        }
+        history->phase = phase;
+        GLFMTouchSample *sample = &history->samples[history->index];
+        sample->timestamp = timestamp;
+        sample->x = x;
+        sample->y = y;
+        history->index = (history->index + 1) % GLFM_TOUCH_HISTORY_SIZE;
+        if (history->count < GLFM_TOUCH_HISTORY_SIZE) {
+            history->count++;
+        }
+    }
+}
+
+/// Removes ended and cancelled touches from the polled state. Called by the platform after the render function.
+static void glfm__clearEndedTouches(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    for (int i = 0; i < GLFM_MAX_TRACKED_TOUCHES; i++) {
+        GLFMTouchHistory *history = &display->touchHistory[i];
+        if (history->ended) {
+            history->ended = false;
+            history->count = 0;
+        }
+    }
+}
+
+/// Sends the held move event of a touch, if any.
+static void glfm__flushCoalescedTouch(GLFMDisplay *display, int touch) {
+    GLFMCoalescedTouch *coalescedTouch = &display->coalescedTouches[touch];
+    if (coalescedTouch->pending) {
+        coalescedTouch->pending = false;
+        if (display->touchFunc) {
+            display->touchFunc(display, touch, coalescedTouch->phase, coalescedTouch->x, coalescedTouch->y);
+        }
+    }
+}
+
+/// Sends all held move events. Called by the platform right before the render function.
+static void glfm__flushCoalescedTouches(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    for (int i = 0; i < GLFM_MAX_TRACKED_TOUCHES; i++) {
+        glfm__flushCoalescedTouch(display, i);
+    }
+}
+
+/// Records the touch for prediction, and sends it to the app's touch function (or holds it, if touch coalescing is
+/// enabled). The timestamp is when the touch occurred, in the ``glfmGetTime`` timebase. Returns the value from the
+/// touch function, or false if there isn't one.
+static bool glfm__sendTouchEvent(GLFMDisplay *display, int touch, GLFMTouchPhase phase, double x, double y,
+                                 double timestamp) {
+    glfm__recordTouch(display, touch, phase, x, y, timestamp);
+    if (touch >= 0 && touch < GLFM_MAX_TRACKED_TOUCHES) {
+        GLFMCoalescedTouch *coalescedTouch = &display->coalescedTouches[touch];
+        const bool coalesce = (display->touchCoalescingEnabled &&
+                               (phase == GLFMTouchPhaseMoved || phase == GLFMTouchPhaseHover));
+        if (!coalesce || coalescedTouch->phase != phase) {
+            glfm__flushCoalescedTouch(display, touch);
+        }
+        if (coalesce) {
+            coalescedTouch->x = x;
+            coalescedTouch->y = y;
+            coalescedTouch->phase = phase;
+            coalescedTouch->pending = true;
+            return display->touchFunc != NULL;
+        }
+    }
+    if (display->touchFunc) {
+        return display->touchFunc(display, touch, phase, x, y);
+    }
+    return false;
+}
+
+/// Cancels the touch, if it is active, at its last position. The timestamp is in the ``glfmGetTime`` timebase.
+static inline void glfm__cancelTouch(GLFMDisplay *display, int touch, double timestamp) {
+    if (touch < 0 || touch >= GLFM_MAX_TRACKED_TOUCHES) {
+        return;
+    }
+    const GLFMTouchHistory *history = &display->touchHistory[touch];
+    if (history->active && history->count > 0) {
+        const int newestIndex = (history->index + GLFM_TOUCH_HISTORY_SIZE - 1) % GLFM_TOUCH_HISTORY_SIZE;
+        const GLFMTouchSample *newest = &history->samples[newestIndex];
+        glfm__sendTouchEvent(display, touch, GLFMTouchPhaseCancelled, newest->x, newest->y, timestamp);
+    }
+}
+
+/// Cancels the touch if it is hovering. Called by the platform when the mouse leaves the view.
+static inline void glfm__cancelHover(GLFMDisplay *display, int touch, double timestamp) {
+    if (touch >= 0 && touch < GLFM_MAX_TRACKED_TOUCHES &&
+        display->touchHistory[touch].phase == GLFMTouchPhaseHover) {
+        glfm__cancelTouch(display, touch, timestamp);
+    }
+}
+
+#if GLFM_FEATURE_KEYBOARD
+
+/// Updates the key state for ``glfmIsKeyDown``, and sends the event to the app's key function. Returns the value from
+/// the key function, or false if there isn't one.
+static bool glfm__sendKeyEvent(GLFMDisplay *display, GLFMKeyCode keyCode, GLFMKeyAction action, int modifiers) {
+    const unsigned int index = (unsigned int)keyCode;
+    if (keyCode != GLFMKeyCodeUnknown && index < GLFM_KEY_STATE_WORDS * 32) {
+        const uint32_t mask = (uint32_t)1 << (index % 32);
+        if (action == GLFMKeyActionReleased) {
+            display->keysDown[index / 32] &= ~mask;
+        } else {
+            display->keysDown[index / 32] |= mask;
+        }
+    }
+    if (display->keyFunc) {
+        return display->keyFunc(display, keyCode, action, modifiers);
+    }
+    return false;
+}
+
+#endif // GLFM_FEATURE_KEYBOARD
+
+/// Marks all keys as up. Called by the platform when the app loses focus, since release events may not be delivered.
+static void glfm__clearKeysDown(GLFMDisplay *display) {
+    if (display) {
+        memset(display->keysDown, 0, sizeof(display->keysDown));
+    }
+}
+
+#if GLFM_FEATURE_SENSORS
+
+/// Returns true if the app has a callback for the sensor at `index`.
+static inline bool glfm__isSensorRequested(const GLFMDisplay *display, int index) {
+    return (display && index >= 0 && index < GLFM_NUM_SENSORS &&
+            (display->sensorFuncs[index] != NULL || display->sensorBatchFuncs[index] != NULL));
+}
+
+/// Adds a sensor event to the sensor's history. Events that are not newer than the newest event are ignored.
+static inline void glfm__addSensorHistory(GLFMDisplay *display, const GLFMSensorEvent *event) {
+    const int index = (int)event->sensor;
+    if (!display || index < 0 || index >= GLFM_NUM_SENSORS) {
+        return;
+    }
+    const int next = display->sensorHistoryIndex[index];
+    const int count = display->sensorHistoryCount[index];
+    if (count > 0) {
+        const int newest = (next + GLFM_SENSOR_HISTORY_SIZE - 1) % GLFM_SENSOR_HISTORY_SIZE;
+        if (event->timestamp <= display->sensorHistory[index][newest].timestamp) {
+            return;
+        }
+    }
+    display->sensorHistory[index][next] = *event;
+    display->sensorHistoryIndex[index] = (next + 1) % GLFM_SENSOR_HISTORY_SIZE;
+    if (count < GLFM_SENSOR_HISTORY_SIZE) {
+        display->sensorHistoryCount[index] = count + 1;
+    }
+}
+
+static inline void glfm__clearSensorHistory(GLFMDisplay *display, int index) {
+    if (display && index >= 0 && index < GLFM_NUM_SENSORS) {
+        display->sensorHistoryCount[index] = 0;
+    }
+}
+
+#endif // GLFM_FEATURE_SENSORS
+
+/// Gets the unit quaternion (x, y, z, w) of the rotation matrix in `event`.
+static void glfm__getSensorQuaternion(const GLFMSensorEvent *event, double q[4]) {
+    const double m00 = event->matrix.m00, m01 = event->matrix.m01, m02 = event->matrix.m02;
+    const double m10 = event->matrix.m10, m11 = event->matrix.m11, m12 = event->matrix.m12;
+    const double m20 = event->matrix.m20, m21 = event->matrix.m21, m22 = event->matrix.m22;
+    const double trace = m00 + m11 + m22;
+    if (trace > 0.0) {
+        const double s = sqrt(trace + 1.0) * 2.0;
+        q[0] = (m21 - m12) / s;
+        q[1] = (m02 - m20) / s;
+        q[2] = (m10 - m01) / s;
+        q[3] = s / 4.0;
+    } else if (m00 > m11 && m00 > m22) {
+        const double s = sqrt(1.0 + m00 - m11 - m22) * 2.0;
+        q[0] = s / 4.0;
+        q[1] = (m01 + m10) / s;
+        q[2] = (m02 + m20) / s;
+        q[3] = (m21 - m12) / s;
+    } else if (m11 > m22) {
+        const double s = sqrt(1.0 + m11 - m00 - m22) * 2.0;
+        q[0] = (m01 + m10) / s;
+        q[1] = s / 4.0;
+        q[2] = (m12 + m21) / s;
+        q[3] = (m02 - m20) / s;
+    } else {
+        const double s = sqrt(1.0 + m22 - m00 - m11) * 2.0;
+        q[0] = (m02 + m20) / s;
+        q[1] = (m12 + m21) / s;
+        q[2] = s / 4.0;
+        q[3] = (m10 - m01) / s;
+    }
+}
+
+/// Sets the rotation matrix in `event` from the quaternion (x, y, z, w). The quaternion is normalized first.
+static void glfm__setSensorQuaternion(GLFMSensorEvent *event, const double q[4]) {
+    const double length = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    const double scale = length > 0.0 ? 1.0 / length : 0.0;
+    const double x = q[0] * scale;
+    const double y = q[1] * scale;
+    const double z = q[2] * scale;
+    const double w = length > 0.0 ? q[3] * scale : 1.0;
+    event->matrix.m00 = 1.0 - 2.0 * (y * y + z * z);
+    event->matrix.m01 = 2.0 * (x * y - z * w);
+    event->matrix.m02 = 2.0 * (x * z + y * w);
+    event->matrix.m10 = 2.0 * (x * y + z * w);
+    event->matrix.m11 = 1.0 - 2.0 * (x * x + z * z);
+    event->matrix.m12 = 2.0 * (y * z - x * w);
+    event->matrix.m20 = 2.0 * (x * z - y * w);
+    event->matrix.m21 = 2.0 * (y * z + x * w);
+    event->matrix.m22 = 1.0 - 2.0 * (x * x + y * y);
+}
+
+/// Spherical linear interpolation from quaternion `a` to `b`. Values of `t` outside of 0...1 extrapolate along the
+/// same arc.
+static void glfm__slerp(const double a[4], const double b[4], double t, double result[4]) {
+    double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    double sign = 1.0;
+    if (dot < 0.0) {
+        // Take the shorter path
+        dot = -dot;
+        sign = -1.0;
+    }
+    double weightA, weightB;
+    if (dot > 0.9995) {
+        // Nearly parallel; use linear interpolation to avoid dividing by a tiny sine
+        weightA = 1.0 - t;
+        weightB = t;
+    } else {
+        const double angle = acos(dot);
+        const double sinAngle = sin(angle);
+        weightA = sin((1.0 - t) * angle) / sinAngle;
+        weightB = sin(t * angle) / sinAngle;
+    }
+    for (int i = 0; i < 4; i++) {
+        result[i] = weightA * a[i] + sign * weightB * b[i];
+    }
+}
+
+/// Sets `matrix` to a column-major matrix that rotates clip space by `transform`.
+static void glfm__getPreTransformMatrix(GLFMSurfaceTransform transform, float matrix[16]) {
+    float cosAngle, sinAngle;
+    switch (transform) {
+        case GLFMSurfaceTransformIdentity: default:
+            cosAngle = 1.0f;
+            sinAngle = 0.0f;
+            break;
+        case GLFMSurfaceTransformRotate90:
+            cosAngle = 0.0f;
+            sinAngle = 1.0f;
+            break;
+        case GLFMSurfaceTransformRotate180:
+            cosAngle = -1.0f;
+            sinAngle = 0.0f;
+            break;
+        case GLFMSurfaceTransformRotate270:
+            cosAngle = 0.0f;
+            sinAngle = -1.0f;
+            break;
+    }
+    memset(matrix, 0, 16 * sizeof(float));
+    matrix[0] = cosAngle;
+    matrix[1] = sinAngle;
+    matrix[4] = -sinAngle;
+    matrix[5] = cosAngle;
+    matrix[10] = 1.0f;
+    matrix[15] = 1.0f;
+}
+
+/// Gets the render scale that should be applied to the backbuffer. A `renderScale` of zero means it was never set.
+static double glfm__getRenderScale(const GLFMDisplay *display) {
+    if (!display || display->renderScale <= 0.0) {
+        return 1.0;
+    }
+    if (display->renderScaleAutomatic && display->autoRenderScale.scale > 0.0) {
+        return display->autoRenderScale.scale;
+    }
+    return display->renderScale;
+}
+
+/// Updates the automatic render scale from the duration of the last frame. Returns true if the scale changed.
+///
+/// The scale is lowered when the average frame duration is well over the target, and raised again, one step at a
+/// time, after the frame rate has been stable for a while. Each failed attempt to raise the scale doubles the wait
+/// before the next attempt, so the scale doesn't oscillate when the app is right at the edge of its budget.
+static inline bool glfm__updateAutomaticRenderScale(GLFMDisplay *display, double frameDuration,
+                                                    double targetFrameDuration) {
+    if (!display || !display->renderScaleAutomatic || targetFrameDuration <= 0.0 || frameDuration <= 0.0 ||
+        frameDuration > GLFM_AUTO_RENDER_SCALE_MAX_FRAME_DURATION) {
+        // Ignore long pauses, like when the app was in the background.
+        return false;
+    }
+
+    const double maxScale = display->renderScale > 0.0 ? display->renderScale : 1.0;
+    const double minScale = maxScale < GLFM_AUTO_RENDER_SCALE_MIN ? maxScale : GLFM_AUTO_RENDER_SCALE_MIN;
+    const double scale = glfm__getRenderScale(display);
+
+    if (display->autoRenderScale.averageFrameDuration <= 0.0) {
+        display->autoRenderScale.averageFrameDuration = frameDuration;
+    } else {
+        display->autoRenderScale.averageFrameDuration +=
+            (frameDuration - display->autoRenderScale.averageFrameDuration) * 0.1;
+    }
+    if (display->autoRenderScale.cooldownFrames > 0) {
+        display->autoRenderScale.cooldownFrames--;
+        return false;
+    }
+
+    const double load = display->autoRenderScale.averageFrameDuration / targetFrameDuration;
+    double newScale = scale;
+    bool changed = false;
+    int upscaleDelayFrames = display->autoRenderScale.upscaleDelayFrames;
+    if (upscaleDelayFrames < GLFM_AUTO_RENDER_SCALE_UPSCALE_MIN_FRAMES) {
+        upscaleDelayFrames = GLFM_AUTO_RENDER_SCALE_UPSCALE_MIN_FRAMES;
+    }
+    if (load > 1.2 && scale > minScale) {
+        newScale = scale - GLFM_AUTO_RENDER_SCALE_STEP;
+        if (newScale < minScale) {
+            newScale = minScale;
+        }
+        changed = true;
+        upscaleDelayFrames *= 2;
+        if (upscaleDelayFrames > GLFM_AUTO_RENDER_SCALE_UPSCALE_MAX_FRAMES) {
+            upscaleDelayFrames = GLFM_AUTO_RENDER_SCALE_UPSCALE_MAX_FRAMES;
+        }
+        display->autoRenderScale.upscaleDelayFrames = upscaleDelayFrames;
+        display->autoRenderScale.stableFrames = 0;
+    } else if (load < 1.05 && scale < maxScale) {
+        display->autoRenderScale.stableFrames++;
+        if (display->autoRenderScale.stableFrames >= upscaleDelayFrames) {
+            newScale = scale + GLFM_AUTO_RENDER_SCALE_STEP;
+            if (newScale > maxScale) {
+                newScale = maxScale;
+            }
+            changed = true;
+            display->autoRenderScale.stableFrames = 0;
+        }
+    } else {
+        display->autoRenderScale.stableFrames = 0;
+    }
+
+    if (!changed) {
+        return false;
+    }
+    display->autoRenderScale.scale = newScale;
+    display->autoRenderScale.cooldownFrames = GLFM_AUTO_RENDER_SCALE_COOLDOWN_FRAMES;
+    display->autoRenderScale.averageFrameDuration = 0.0;
+    return true;
+}
+
+// MARK: - Touch coalescing
+
+void glfmSetTouchCoalescingEnabled(GLFMDisplay *display, bool enabled) {
+    if (display && display->touchCoalescingEnabled != enabled) {
+        display->touchCoalescingEnabled = enabled;
+        if (!enabled) {
+            glfm__flushCoalescedTouches(display);
+        }
+    }
+}
+
+// MARK: - Polled input state
+
+/// Enables input state tracking the first time the polled input state is read, unless the app has set it.
+static void glfm__inputStatePolled(const GLFMDisplay *display) {
+    if (display && !display->inputStateTrackingEnabled && !display->inputStateTrackingSet) {
+        // Reading the state doesn't change it; only which events are received changes.
+        GLFMDisplay *mutableDisplay = (GLFMDisplay *)display;
+        mutableDisplay->inputStateTrackingEnabled = true;
+        glfm__inputFuncUpdated(mutableDisplay);
+    }
+}
+
+int glfmGetTouchState(const GLFMDisplay *display, GLFMTouchState *touches, int maxTouches) {
+    if (!display) {
+        return 0;
+    }
+    glfm__inputStatePolled(display);
+    int count = 0;
+    for (int i = 0; i < GLFM_MAX_TRACKED_TOUCHES; i++) {
+        const GLFMTouchHistory *history = &display->touchHistory[i];
+        if ((!history->active && !history->ended) || history->count == 0) {
+            continue;
+        }
+        if (touches && count < maxTouches) {
+            const int newestIndex = (history->index + GLFM_TOUCH_HISTORY_SIZE - 1) % GLFM_TOUCH_HISTORY_SIZE;
+            touches[count].touch = i;
+            touches[count].phase = history->phase;
+            touches[count].x = history->samples[newestIndex].x;
+            touches[count].y = history->samples[newestIndex].y;
+        }
+        count++;
+    }
+    return count;
+}
+
+#if GLFM_FEATURE_KEYBOARD
+
+bool glfmIsKeyDown(const GLFMDisplay *display, GLFMKeyCode keyCode) {
+    const unsigned int index = (unsigned int)keyCode;
+    if (!display || index >= GLFM_KEY_STATE_WORDS * 32) {
+        return false;
+    }
+    glfm__inputStatePolled(display);
+    return (display->keysDown[index / 32] & ((uint32_t)1 << (index % 32))) != 0;
+}
+
+#endif // GLFM_FEATURE_KEYBOARD
+
+// MARK: - Touch prediction
+
+bool glfmGetPredictedTouch(const GLFMDisplay *display, int touch, double time, double *x, double *y) {
+    glfm__inputStatePolled(display);
+    if (!display || touch < 0 || touch >= GLFM_MAX_TRACKED_TOUCHES || !display->touchHistory[touch].active ||
+        display->touchHistory[touch].count == 0) {
+        return false;
+    }
+    const GLFMTouchHistory *history = &display->touchHistory[touch];
+    const int newestIndex = (history->index + GLFM_TOUCH_HISTORY_SIZE - 1) % GLFM_TOUCH_HISTORY_SIZE;
+    const GLFMTouchSample *newest = &history->samples[newestIndex];
+
+    // Least-squares fit of position over time, using the samples in the prediction window. Times are relative to the
+    // newest sample to keep the sums well-conditioned.
+    double sumT = 0.0, sumTT = 0.0, sumX = 0.0, sumY = 0.0, sumTX = 0.0, sumTY = 0.0;
+    int n = 0;
+    for (int i = 0; i < history->count; i++) {
+        const GLFMTouchSample *sample = &history->samples[(newestIndex + GLFM_TOUCH_HISTORY_SIZE - i) %
+                                                          GLFM_TOUCH_HISTORY_SIZE];
+        const double t = sample->timestamp - newest->timestamp;
+        if (t < -GLFM_TOUCH_PREDICTION_WINDOW) {
+            break;
+        }
+        sumT += t;
+        sumTT += t * t;
+        sumX += sample->x;
+        sumY += sample->y;
+        sumTX += t * sample->x;
+        sumTY += t * sample->y;
+        n++;
+    }
+    double velocityX = 0.0;
+    double velocityY = 0.0;
+    const double denominator = n * sumTT - sumT * sumT;
+    if (n >= 2 && denominator > 0.0) {
+        velocityX = (n * sumTX - sumT * sumX) / denominator;
+        velocityY = (n * sumTY - sumT * sumY) / denominator;
+    }
+
+    double dt = time - newest->timestamp;
+    if (dt < 0.0) {
+        dt = 0.0;
+    } else if (dt > GLFM_TOUCH_PREDICTION_MAX_TIME) {
+        dt = GLFM_TOUCH_PREDICTION_MAX_TIME;
+    }
+    if (x) {
+        *x = newest->x + velocityX * dt;
+    }
+    if (y) {
+        *y = newest->y + velocityY * dt;
+    }
+    return true;
+}
+
+// MARK: - Sensor history
+
+bool glfmGetSensorRotationQuaternion(const GLFMDisplay *display, double quaternion[4]) {
+    if (!display || !quaternion) {
+        return false;
+    }
+    if (display->sensorFusionQuaternionValid) {
+        memcpy(quaternion, display->sensorFusionQuaternion, sizeof(display->sensorFusionQuaternion));
+        return true;
+    }
+    const int index = (int)GLFMSensorRotationMatrix;
+    if (display->sensorHistoryCount[index] == 0) {
+        return false;
+    }
+    const int newestIndex = (display->sensorHistoryIndex[index] + GLFM_SENSOR_HISTORY_SIZE - 1) %
+        GLFM_SENSOR_HISTORY_SIZE;
+    glfm__getSensorQuaternion(&display->sensorHistory[index][newestIndex], quaternion);
+    return true;
+}
+
+bool glfmGetSensorSampleAt(const GLFMDisplay *display, GLFMSensor sensor, double time, GLFMSensorEvent *event) {
+    const int index = (int)sensor;
+    if (!display || !event || index < 0 || index >= GLFM_NUM_SENSORS || display->sensorHistoryCount[index] == 0) {
+        return false;
+    }
+    const GLFMSensorEvent *history = display->sensorHistory[index];
+    const int count = display->sensorHistoryCount[index];
+    const int newestIndex = (display->sensorHistoryIndex[index] + GLFM_SENSOR_HISTORY_SIZE - 1) %
+        GLFM_SENSOR_HISTORY_SIZE;
+    const GLFMSensorEvent *newest = &history[newestIndex];
+    const GLFMSensorEvent *oldest = &history[(newestIndex + GLFM_SENSOR_HISTORY_SIZE - (count - 1)) %
+                                             GLFM_SENSOR_HISTORY_SIZE];
+    double timestamp = glfm__getSensorTimestamp(time);
+    if (count == 1) {
+        *event = *newest;
+        return true;
+    } else if (timestamp <= oldest->timestamp) {
+        *event = *oldest;
+        return true;
+    }
+
+    // Find the samples before (a) and after (b) the timestamp. History timestamps are strictly increasing.
+    const GLFMSensorEvent *a;
+    const GLFMSensorEvent *b;
+    if (timestamp >= newest->timestamp) {
+        // Extrapolate from the two newest samples
+        if (timestamp > newest->timestamp + GLFM_SENSOR_HISTORY_MAX_EXTRAPOLATION) {
+            timestamp = newest->timestamp + GLFM_SENSOR_HISTORY_MAX_EXTRAPOLATION;
+        }
+        a = &history[(newestIndex + GLFM_SENSOR_HISTORY_SIZE - 1) % GLFM_SENSOR_HISTORY_SIZE];
+        b = newest;
+    } else {
+        b = newest;
+        a = newest;
+        for (int i = 1; i < count; i++) {
+            a = &history[(newestIndex + GLFM_SENSOR_HISTORY_SIZE - i) % GLFM_SENSOR_HISTORY_SIZE];
+            if (a->timestamp <= timestamp) {
+                break;
+            }
+            b = a;
+        }
+    }
+
+    const double t = (timestamp - a->timestamp) / (b->timestamp - a->timestamp);
+    *event = *b;
+    event->timestamp = timestamp;
+    if (sensor == GLFMSensorRotationMatrix) {
+        double qa[4], qb[4], q[4];
+        glfm__getSensorQuaternion(a, qa);
+        glfm__getSensorQuaternion(b, qb);
+        glfm__slerp(qa, qb, t, q);
+        glfm__setSensorQuaternion(event, q);
+    } else {
+        event->vector.x = a->vector.x + (b->vector.x - a->vector.x) * t;
+        event->vector.y = a->vector.y + (b->vector.y - a->vector.y) * t;
+        event->vector.z = a->vector.z + (b->vector.z - a->vector.z) * t;
+    }
+    return true;
+}
+
+// MARK: - Resources
+
+int glfmAddResource(GLFMDisplay *display, GLFMResourceCreateFunc createFunc, const void *data, size_t size,
+                    void *userData) {
+    if (!display || !createFunc) {
+        return 0;
+    }
+    if (display->resourceCount == display->resourceCapacity) {
+        int newCapacity = display->resourceCapacity > 0 ? display->resourceCapacity * 2 : 16;
+        GLFMResource *newResources = realloc(display->resources, (size_t)newCapacity * sizeof(GLFMResource));
+        if (!newResources) {
+            return 0;
+        }
+        display->resources = newResources;
+        display->resourceCapacity = newCapacity;
+    }
+    void *dataCopy = NULL;
+    if (data && size > 0) {
+        dataCopy = malloc(size);
+        if (!dataCopy) {
+            return 0;
+        }
+        memcpy(dataCopy, data, size);
+    }
+    GLFMResource *resource = &display->resources[display->resourceCount++];
+    resource->id = ++display->lastResourceID;
+    resource->createFunc = createFunc;
+    resource->data = dataCopy;
+    resource->size = dataCopy ? size : 0;
+    resource->userData = userData;
+    resource->ready = false;
+    display->pendingResourceCount++;
+    return resource->id;
+}
+
+void glfmRemoveResource(GLFMDisplay *display, int resourceID) {
+    if (!display) {
+        return;
+    }
+    for (int i = 0; i < display->resourceCount; i++) {
+        GLFMResource *resource = &display->resources[i];
+        if (resource->id == resourceID) {
+            if (!resource->ready) {
+                display->pendingResourceCount--;
+            }
+            free(resource->data);
+            display->resourceCount--;
+            memmove(resource, resource + 1, (size_t)(display->resourceCount - i) * sizeof(GLFMResource));
+            return;
+        }
+    }
+}
+
+bool glfmIsResourceReady(const GLFMDisplay *display, int resourceID) {
+    if (!display) {
+        return false;
+    }
+    for (int i = 0; i < display->resourceCount; i++) {
+        if (display->resources[i].id == resourceID) {
+            return display->resources[i].ready;
+        }
+    }
+    return false;
+}
+
+bool glfmHasPendingResources(const GLFMDisplay *display) {
+    return display ? display->pendingResourceCount > 0 : false;
+}
+
+/// Marks every resource as pending. Called when the surface is destroyed.
+static inline void glfm__invalidateResources(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    for (int i = 0; i < display->resourceCount; i++) {
+        display->resources[i].ready = false;
+    }
+    display->pendingResourceCount = display->resourceCount;
+}
+
+/// Creates pending resources, in order, for up to GLFM_RESOURCE_CREATE_BUDGET seconds (at least one resource).
+/// Called before each GLFMRenderFunc call while the surface exists.
+static void glfm__createPendingResources(GLFMDisplay *display) {
+    if (!display || display->pendingResourceCount <= 0) {
+        return;
+    }
+    const double startTime = glfmGetTime();
+    bool created = false;
+    for (int i = 0; i < display->resourceCount; i++) {
+        if (display->resources[i].ready) {
+            continue;
+        }
+        if (created && glfmGetTime() - startTime >= GLFM_RESOURCE_CREATE_BUDGET) {
+            break;
+        }
+        display->resources[i].ready = true;
+        display->pendingResourceCount--;
+        created = true;
+
+        // Copy, since the create function may add or remove other resources
+        GLFMResource resource = display->resources[i];
+        resource.createFunc(display, resource.data, resource.size, resource.userData);
+    }
+}
+
+// MARK: - Extensions
+
+/// Returns true if `name` is a complete entry in the space-separated list of `extensions`.
+static bool glfm__hasExtension(const char *extensions, const char *name) {
+    if (!extensions || !name) {
+        return false;
+    }
+    const size_t nameLength = strlen(name);
+    const char *start = extensions;
+    const char *found;
+    while ((found = strstr(start, name)) != NULL) {
+        const char *end = found + nameLength;
+        if ((found == extensions || found[-1] == ' ') && (*end == ' ' || *end == '\0')) {
+            return true;
+        }
+        start = end;
+    }
+    return false;
+}
+
+/// Clears the list cached by ``glfmIsExtensionSupported``. Called when the surface is destroyed.
+static inline void glfm__clearSupportedExtensions(GLFMDisplay *display) {
+    if (display) {
+        free(display->supportedExtensions);
+        display->supportedExtensions = NULL;
+    }
+}
+
+bool glfmIsExtensionSupported(GLFMDisplay *display, const char *extension) {
+    if (!display || !extension || extension[0] == '\0') {
+        return false;
+    }
+    if (!display->supportedExtensions) {
+        display->supportedExtensions = glfm__copySupportedExtensions(display);
+    }
+    return glfm__hasExtension(display->supportedExtensions, extension);
+}
+
+// MARK: - Display
+
+/// Frees the memory owned by the display (resources, their data, and extension lists), but not the display itself.
+/// Called by a platform just before it frees the display. Android and Emscripten keep the display for the lifetime of
+/// the process, so only Apple platforms call this.
+static inline void glfm__freeDisplayData(GLFMDisplay *display) {
+    if (!display) {
+        return;
+    }
+    for (int i = 0; i < display->resourceCount; i++) {
+        free(display->resources[i].data);
+    }
+    free(display->resources);
+    display->resources = NULL;
+    display->resourceCount = 0;
+    display->resourceCapacity = 0;
+    display->pendingResourceCount = 0;
+
+    glfm__clearSupportedExtensions(display);
+    for (int i = 0; i < display->enabledExtensionCount; i++) {
+        free(display->enabledExtensions[i]);
+    }
+    free(display->enabledExtensions);
+    display->enabledExtensions = NULL;
+    display->enabledExtensionCount = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,185 @@
+// GLFM
+// https://github.com/brackeen/glfm
+
+#ifndef GLFM_KEYBOARD_TABLES_H
+#define GLFM_KEYBOARD_TABLES_H
+
+// Perfect hash tables for KeyboardEvent.code and KeyboardEvent.key values, used by the web backend. A value is hashed
+// once to find its bucket, and hashed again with the bucket's seed to find its slot, so a lookup is two hashes and one
+// strcmp. To add values, edit tests/gen_keyboard_tables.py and run it. See tests/unit/keyboard_tables_test.c.
+
+#include "glfm.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// BEGIN GENERATED KEYBOARD TABLES (tests/gen_keyboard_tables.py)
+
+#define GLFM_KEYBOARD_CODE_BUCKETS 31
+#define GLFM_KEYBOARD_CODE_SLOTS 128
+#define GLFM_KEYBOARD_KEY_BUCKETS 76
+#define GLFM_KEYBOARD_KEY_SLOTS 512
+
+typedef struct {
+    const char *code;
+    GLFMKeyCode keyCode;
+} GLFMKeyboardCode;
+
+static const uint16_t GLFM_KEYBOARD_CODE_SEEDS[GLFM_KEYBOARD_CODE_BUCKETS] = {
+    80, 1, 10, 95, 7, 41, 2, 5, 4, 1, 7, 2, 51, 14, 60, 5, 2, 14, 82, 158, 1, 121, 111, 1, 29, 7, 4, 40, 30, 16, 0,
+};
+
+static const GLFMKeyboardCode GLFM_KEYBOARD_CODES[GLFM_KEYBOARD_CODE_SLOTS] = {
+    [0] = { "NumpadMultiply", GLFMKeyCodeNumpadMultiply }, [1] = { "ArrowRight", GLFMKeyCodeArrowRight },
+    [2] = { "Numpad1", GLFMKeyCodeNumpad1 }, [3] = { "F14", GLFMKeyCodeF14 },
+    [4] = { "BracketRight", GLFMKeyCodeBracketRight }, [5] = { "Digit1", GLFMKeyCode1 },
+    [6] = { "Digit4", GLFMKeyCode4 }, [7] = { "BrowserBack", GLFMKeyCodeNavigationBack },
+    [8] = { "F13", GLFMKeyCodeF13 }, [9] = { "Fn", GLFMKeyCodeFunction }, [10] = { "ContextMenu", GLFMKeyCodeMenu },
+    [11] = { "PageUp", GLFMKeyCodePageUp }, [12] = { "F21", GLFMKeyCodeF21 }, [13] = { "KeyG", GLFMKeyCodeG },
+    [14] = { "Enter", GLFMKeyCodeEnter }, [15] = { "ControlRight", GLFMKeyCodeControlRight },
+    [16] = { "Semicolon", GLFMKeyCodeSemicolon }, [18] = { "Numpad0", GLFMKeyCodeNumpad0 },
+    [19] = { "Backslash", GLFMKeyCodeBackslash }, [20] = { "Digit2", GLFMKeyCode2 },
+    [21] = { "Period", GLFMKeyCodePeriod }, [22] = { "KeyA", GLFMKeyCodeA },
+    [24] = { "ControlLeft", GLFMKeyCodeControlLeft }, [25] = { "KeyZ", GLFMKeyCodeZ },
+    [27] = { "NumpadEqual", GLFMKeyCodeNumpadEqual }, [28] = { "KeyU", GLFMKeyCodeU },
+    [29] = { "Escape", GLFMKeyCodeEscape }, [31] = { "F4", GLFMKeyCodeF4 }, [32] = { "Numpad6", GLFMKeyCodeNumpad6 },
+    [33] = { "NumLock", GLFMKeyCodeNumLock }, [34] = { "Digit8", GLFMKeyCode8 },
+    [35] = { "MetaLeft", GLFMKeyCodeMetaLeft }, [36] = { "Digit6", GLFMKeyCode6 },
+    [37] = { "AltLeft", GLFMKeyCodeAltLeft }, [38] = { "BracketLeft", GLFMKeyCodeBracketLeft },
+    [39] = { "MediaPlayPause", GLFMKeyCodeMediaPlayPause }, [40] = { "Help", GLFMKeyCodeInsert },
+    [41] = { "KeyR", GLFMKeyCodeR }, [42] = { "F15", GLFMKeyCodeF15 }, [43] = { "KeyD", GLFMKeyCodeD },
+    [44] = { "Numpad5", GLFMKeyCodeNumpad5 }, [45] = { "F17", GLFMKeyCodeF17 }, [46] = { "KeyJ", GLFMKeyCodeJ },
+    [47] = { "NumpadAdd", GLFMKeyCodeNumpadAdd }, [48] = { "KeyO", GLFMKeyCodeO }, [49] = { "Digit5", GLFMKeyCode5 },
+    [50] = { "MetaRight", GLFMKeyCodeMetaRight }, [51] = { "KeyY", GLFMKeyCodeY },
+    [52] = { "Numpad3", GLFMKeyCodeNumpad3 }, [53] = { "KeyF", GLFMKeyCodeF }, [54] = { "KeyC", GLFMKeyCodeC },
+    [55] = { "Space", GLFMKeyCodeSpace }, [56] = { "PageDown", GLFMKeyCodePageDown },
+    [57] = { "NumpadSubtract", GLFMKeyCodeNumpadSubtract }, [58] = { "F18", GLFMKeyCodeF18 },
+    [59] = { "KeyH", GLFMKeyCodeH }, [60] = { "Backquote", GLFMKeyCodeBackquote }, [61] = { "F2", GLFMKeyCodeF2 },
+    [62] = { "Digit3", GLFMKeyCode3 }, [63] = { "KeyT", GLFMKeyCodeT }, [64] = { "Numpad8", GLFMKeyCodeNumpad8 },
+    [65] = { "NumpadDivide", GLFMKeyCodeNumpadDivide }, [66] = { "F10", GLFMKeyCodeF10 },
+    [67] = { "F24", GLFMKeyCodeF24 }, [68] = { "Numpad7", GLFMKeyCodeNumpad7 },
+    [69] = { "ShiftLeft", GLFMKeyCodeShiftLeft }, [70] = { "KeyQ", GLFMKeyCodeQ },
+    [71] = { "ArrowDown", GLFMKeyCodeArrowDown }, [72] = { "CapsLock", GLFMKeyCodeCapsLock },
+    [73] = { "Digit9", GLFMKeyCode9 }, [74] = { "F23", GLFMKeyCodeF23 }, [75] = { "Numpad2", GLFMKeyCodeNumpad2 },
+    [76] = { "Equal", GLFMKeyCodeEqual }, [77] = { "End", GLFMKeyCodeEnd }, [78] = { "F19", GLFMKeyCodeF19 },
+    [79] = { "Quote", GLFMKeyCodeQuote }, [80] = { "F1", GLFMKeyCodeF1 }, [81] = { "Home", GLFMKeyCodeHome },
+    [82] = { "ArrowLeft", GLFMKeyCodeArrowLeft }, [83] = { "PrintScreen", GLFMKeyCodePrintScreen },
+    [84] = { "KeyK", GLFMKeyCodeK }, [85] = { "ScrollLock", GLFMKeyCodeScrollLock }, [86] = { "KeyM", GLFMKeyCodeM },
+    [87] = { "Slash", GLFMKeyCodeSlash }, [88] = { "KeyP", GLFMKeyCodeP }, [89] = { "KeyB", GLFMKeyCodeB },
+    [90] = { "KeyE", GLFMKeyCodeE }, [91] = { "AltRight", GLFMKeyCodeAltRight },
+    [92] = { "ShiftRight", GLFMKeyCodeShiftRight }, [93] = { "KeyW", GLFMKeyCodeW }, [94] = { "F11", GLFMKeyCodeF11 },
+    [95] = { "Numpad4", GLFMKeyCodeNumpad4 }, [96] = { "F6", GLFMKeyCodeF6 }, [97] = { "F20", GLFMKeyCodeF20 },
+    [98] = { "F7", GLFMKeyCodeF7 }, [99] = { "Digit7", GLFMKeyCode7 }, [100] = { "Power", GLFMKeyCodePower },
+    [101] = { "KeyV", GLFMKeyCodeV }, [102] = { "ArrowUp", GLFMKeyCodeArrowUp }, [103] = { "Digit0", GLFMKeyCode0 },
+    [104] = { "NumpadEnter", GLFMKeyCodeNumpadEnter }, [105] = { "F22", GLFMKeyCodeF22 },
+    [106] = { "Pause", GLFMKeyCodePause }, [107] = { "KeyX", GLFMKeyCodeX }, [108] = { "F12", GLFMKeyCodeF12 },
+    [110] = { "KeyI", GLFMKeyCodeI }, [111] = { "Comma", GLFMKeyCodeComma }, [112] = { "KeyL", GLFMKeyCodeL },
+    [114] = { "Backspace", GLFMKeyCodeBackspace }, [115] = { "Tab", GLFMKeyCodeTab },
+    [116] = { "F16", GLFMKeyCodeF16 }, [117] = { "KeyN", GLFMKeyCodeN }, [118] = { "KeyS", GLFMKeyCodeS },
+    [119] = { "F3", GLFMKeyCodeF3 }, [120] = { "Insert", GLFMKeyCodeInsert }, [121] = { "Minus", GLFMKeyCodeMinus },
+    [122] = { "F9", GLFMKeyCodeF9 }, [123] = { "Numpad9", GLFMKeyCodeNumpad9 },
+    [124] = { "NumpadDecimal", GLFMKeyCodeNumpadDecimal }, [125] = { "F5", GLFMKeyCodeF5 },
+    [126] = { "Delete", GLFMKeyCodeDelete }, [127] = { "F8", GLFMKeyCodeF8 },
+};
+
+static const uint16_t GLFM_KEYBOARD_KEY_SEEDS[GLFM_KEYBOARD_KEY_BUCKETS] = {
+    8, 3, 4, 1, 2, 15, 1, 2, 12, 3, 1, 1, 2, 8, 2, 2, 10, 2, 7, 1, 6, 1, 2, 4, 8, 2, 1, 5, 3, 3, 2, 6, 2, 4, 1, 3, 13,
+    5, 13, 2, 3, 3, 6, 1, 2, 1, 5, 1, 1, 3, 1, 4, 0, 5, 9, 1, 6, 1, 10, 1, 1, 5, 20, 3, 4, 2, 11, 8, 4, 9, 4, 3, 56, 3,
+    5, 13,
+};
+
+static const char *GLFM_KEYBOARD_KEYS[GLFM_KEYBOARD_KEY_SLOTS] = {
+    [0] = "FavoriteRecall0", [1] = "Redo", [2] = "LaunchScreenSaver", [5] = "MediaAudioTrack", [6] = "FavoriteStore1",
+    [7] = "VideoModeNext", [8] = "InstantReplay", [10] = "LaunchPhone", [11] = "NextFavoriteChannel", [12] = "F10",
+    [14] = "Soft8", [16] = "ZenkakuHankaku", [18] = "TVAudioDescription", [20] = "F6", [23] = "Close", [26] = "Cut",
+    [29] = "MannerMode", [33] = "AudioFaderRear", [34] = "AudioVolumeUp", [35] = "BrightnessDown", [39] = "Settings",
+    [42] = "MediaSkipForward", [46] = "F5", [49] = "ScanChannelsToggle", [50] = "AllCandidates",
+    [52] = "FavoriteClear2", [55] = "F9", [56] = "ArrowUp", [57] = "NavigateOut", [58] = "Dead",
+    [59] = "AudioTrebleUp", [60] = "PageUp", [61] = "ScrollLock", [62] = "Undo", [63] = "TVPower", [64] = "Open",
+    [65] = "MediaLast", [66] = "Lock", [67] = "OnDemand", [68] = "GroupFirst", [69] = "Hyper", [70] = "ListProgram",
+    [71] = "F15", [72] = "F1", [74] = "MicrophoneVolumeMute", [77] = "Fn", [79] = "TVAntennaCable",
+    [80] = "BrowserSearch", [83] = "JunjaMode", [85] = "F11", [86] = "Subtitle", [88] = "RecordSpeedNext",
+    [91] = "BrowserStop", [93] = "PinPToggle", [95] = "ExSel", [96] = "F7", [98] = "DisplaySwap",
+    [99] = "MediaTopMenu", [100] = "TV3DMode", [101] = "RandomToggle", [104] = "Romaji", [106] = "HeadsetHook",
+    [108] = "F12", [112] = "Soft10", [113] = "BrowserHome", [116] = "MediaSkipBackward", [117] = "TVSatelliteBS",
+    [119] = "ColorF3Blue", [122] = "Soft3", [124] = "Eject", [125] = "Execute", [126] = "Cancel",
+    [128] = "MediaStepForward", [129] = "NextUserProfile", [130] = "CameraFocus", [131] = "FavoriteClear3",
+    [134] = "PlaySpeedUp", [137] = "MediaClose", [139] = "Soft5", [141] = "MediaPlay", [143] = "LaunchWebCam",
+    [144] = "TVSatellite", [145] = "LogOff", [148] = "Props", [149] = "FavoriteRecall3", [150] = "ColorF2Yellow",
+    [152] = "ColorF1Green", [153] = "GroupPrevious", [155] = "Enter", [156] = "MediaFastForward", [159] = "F23",
+    [160] = "ColorF5Brown", [161] = "LaunchWebBrowser", [162] = "NavigateIn", [163] = "Hankaku",
+    [168] = "TVInputComponent2", [169] = "Unidentified", [172] = "FavoriteClear0", [174] = "TVTerrestrialAnalog",
+    [175] = "Notification", [176] = "LaunchApplication2", [177] = "TVTimer", [179] = "Call", [180] = "Play",
+    [184] = "Dimmer", [185] = "TVInputComponent1", [187] = "Compose", [188] = "AudioBassBoostDown",
+    [190] = "AudioVolumeDown", [191] = "EraseEof", [194] = "Help", [195] = "F20", [196] = "STBPower",
+    [197] = "LaunchMusicPlayer", [198] = "AVRInput", [199] = "Process", [200] = "PinPMove", [201] = "Link",
+    [204] = "AudioVolumeMute", [205] = "NumLock", [206] = "LaunchSpreadsheet", [209] = "Soft4", [210] = "Alphanumeric",
+    [212] = "TVInputComposite2", [213] = "GuideNextDay", [214] = "Convert", [215] = "FnLock", [216] = "FavoriteClear1",
+    [218] = "BrowserBack", [219] = "GoHome", [221] = "BrowserFavorites", [223] = "VoiceDial", [224] = "ColorF0Red",
+    [226] = "Again", [227] = "Select", [230] = "TVInputHDMI1", [235] = "MediaTrackPrevious",
+    [237] = "LaunchWordProcessor", [240] = "MediaRewind", [242] = "AppSwitch", [243] = "PinPUp",
+    [244] = "AudioFaderFront", [245] = "FavoriteStore2", [246] = "End", [248] = "Pairing", [251] = "MicrophoneToggle",
+    [253] = "F18", [254] = "MediaTrackNext", [255] = "ArrowLeft", [257] = "ZoomOut", [258] = "CodeInput",
+    [260] = "SpeechCorrectionList", [263] = "TVTerrestrialDigital", [265] = "TVMediaContext", [267] = "TVInputHDMI2",
+    [273] = "Pause", [274] = "LiveContent", [275] = "Shift", [277] = "Home", [279] = "AudioSurroundModeNext",
+    [280] = "Accept", [282] = "Katakana", [283] = "AudioBassBoostUp", [286] = "Soft6", [289] = "BrowserRefresh",
+    [292] = "F17", [294] = "TVSatelliteCS", [296] = "Super", [298] = "ArrowDown", [299] = "Insert", [301] = "KanaMode",
+    [302] = "ClosedCaptionToggle", [303] = "AudioTrebleDown", [304] = "TVSatelliteToggle", [305] = "Wink",
+    [306] = "LastNumberRedial", [307] = "PrintScreen", [309] = "Key12", [310] = "F19", [312] = "Attn", [313] = "F14",
+    [315] = "DVR", [316] = "NavigatePrevious", [317] = "Hiragana", [318] = "MediaStop", [323] = "TVRadioService",
+    [324] = "ChannelUp", [326] = "Meta", [327] = "TVDataService", [329] = "F21", [331] = "F13", [332] = "ZoomIn",
+    [333] = "Standby", [335] = "F2", [336] = "ContextMenu", [337] = "Clear", [339] = "FinalMode",
+    [340] = "AudioBalanceLeft", [344] = "F22", [345] = "Backspace", [349] = "CrSel", [351] = "Exit",
+    [352] = "PowerOff", [353] = "WakeUp", [355] = "F8", [358] = "ScreenModeNext", [359] = "NonConvert",
+    [360] = "TVContentsMenu", [364] = "HanjaMode", [366] = "FavoriteStore0", [367] = "AltGraph", [368] = "TVNetwork",
+    [369] = "Hibernate", [373] = "LaunchMediaPlayer", [374] = "GroupNext", [375] = "ChannelDown", [376] = "Soft1",
+    [381] = "PlaySpeedDown", [382] = "Control", [383] = "ArrowRight", [384] = "KanjiMode", [385] = "EndCall",
+    [388] = "MediaPause", [389] = "ColorF4Grey", [390] = "AudioBalanceRight", [393] = "PinPDown", [394] = "Info",
+    [395] = "MicrophoneVolumeDown", [396] = "TVAudioDescriptionMixDown", [397] = "STBInput", [400] = "TVInputHDMI3",
+    [401] = "PreviousCandidate", [404] = "LaunchContacts", [405] = "TVInputHDMI4", [406] = "Alt", [407] = "F4",
+    [408] = "ZoomToggle", [410] = "HiraganaKatakana", [411] = "Key11", [412] = "RfBypass", [414] = "F16",
+    [416] = "SymbolLock", [417] = "ModeChange", [418] = "New", [421] = "Camera", [422] = "MediaStepBackward",
+    [425] = "RcLowBattery", [426] = "Soft2", [429] = "HangulMode", [430] = "F3", [431] = "Soft9", [433] = "TVInput",
+    [434] = "SpeechInputToggle", [435] = "Symbol", [438] = "BrowserForward", [441] = "TVInputComposite1",
+    [442] = "Print", [444] = "MediaPlayPause", [446] = "F24", [449] = "Power", [450] = "LaunchMail", [451] = "Guide",
+    [452] = "MailSend", [453] = "SingleCandidate", [454] = "GoBack", [455] = "FavoriteRecall1", [457] = "CapsLock",
+    [459] = "TVInputVGA1", [460] = "Delete", [462] = "GroupLast", [464] = "FavoriteRecall2", [465] = "PlaySpeedReset",
+    [467] = "Escape", [468] = "TVAudioDescriptionMixUp", [469] = "PageDown", [470] = "BrightnessUp", [472] = "Paste",
+    [473] = "MailReply", [474] = "AudioBassBoostToggle", [475] = "LaunchApplication1", [476] = "Find",
+    [477] = "MediaApps", [480] = "FavoriteStore3", [481] = "TV", [482] = "Eisu", [484] = "LaunchCalendar",
+    [485] = "MediaRecord", [488] = "Teletext", [489] = "TVNumberEntry", [490] = "NavigateNext",
+    [491] = "MicrophoneVolumeUp", [493] = "Copy", [494] = "GuidePreviousDay", [495] = "SplitScreenToggle",
+    [497] = "Zenkaku", [498] = "NextCandidate", [499] = "Tab", [501] = "AVRPower", [503] = "Soft7", [504] = "Save",
+    [507] = "SpellCheck", [510] = "MailForward",
+};
+
+// END GENERATED KEYBOARD TABLES
+
+static uint32_t glfm__keyboardHash(const char *string, uint32_t seed) {
+    // FNV-1a with the seed mixed into the offset basis. Must match keyboard_hash() in tests/gen_keyboard_tables.py.
+    uint32_t hash = 2166136261u ^ seed;
+    for (const char *c = string; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+/// Gets the key code for a KeyboardEvent.code value.
+static GLFMKeyCode glfm__getKeyCode(const char *code) {
+    const uint32_t seed = GLFM_KEYBOARD_CODE_SEEDS[glfm__keyboardHash(code, 0) % GLFM_KEYBOARD_CODE_BUCKETS];
+    const GLFMKeyboardCode *entry = &GLFM_KEYBOARD_CODES[glfm__keyboardHash(code, seed) % GLFM_KEYBOARD_CODE_SLOTS];
+    if (entry->code && strcmp(entry->code, code) == 0) {
+        return entry->keyCode;
+    }
+    return GLFMKeyCodeUnknown;
+}
+
+/// Returns true if the KeyboardEvent.key value is a pre-defined key value (not a printable character).
+static bool glfm__isPredefinedKey(const char *key) {
+    const uint32_t seed = GLFM_KEYBOARD_KEY_SEEDS[glfm__keyboardHash(key, 0) % GLFM_KEYBOARD_KEY_BUCKETS];
+    const char *entry = GLFM_KEYBOARD_KEYS[glfm__keyboardHash(key, seed) % GLFM_KEYBOARD_KEY_SLOTS];
+    return entry && strcmp(entry, key) == 0;
+}
+
+#endif
@@ -0,0 +1,204 @@
+// GLFM
+// https://github.com/brackeen/glfm
+
+#include "glfm_sensor_fusion.h"
+
+#include <math.h>
+#include <string.h>
+
+#define GLFM_SENSOR_FUSION_KP 1.0
+#define GLFM_SENSOR_FUSION_KI 0.001
+#define GLFM_SENSOR_FUSION_MAX_INTERVAL 0.25
+
+void glfm__resetSensorFusion(GLFMSensorFusion *fusion) {
+    memset(fusion, 0, sizeof(GLFMSensorFusion));
+    fusion->quaternion[3] = 1.0;
+}
+
+static bool glfm__normalize3(double v[3]) {
+    const double length = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (length <= 0.0) {
+        return false;
+    }
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+    return true;
+}
+
+static void glfm__cross3(const double a[3], const double b[3], double result[3]) {
+    result[0] = a[1] * b[2] - a[2] * b[1];
+    result[1] = a[2] * b[0] - a[0] * b[2];
+    result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+/// Gets the unit quaternion (x, y, z, w) of the rotation matrix with the rows `r0`, `r1`, and `r2`.
+static void glfm__getRotationQuaternion(const double r0[3], const double r1[3], const double r2[3], double q[4]) {
+    const double trace = r0[0] + r1[1] + r2[2];
+    if (trace > 0.0) {
+        const double s = sqrt(trace + 1.0) * 2.0;
+        q[0] = (r2[1] - r1[2]) / s;
+        q[1] = (r0[2] - r2[0]) / s;
+        q[2] = (r1[0] - r0[1]) / s;
+        q[3] = s / 4.0;
+    } else if (r0[0] > r1[1] && r0[0] > r2[2]) {
+        const double s = sqrt(1.0 + r0[0] - r1[1] - r2[2]) * 2.0;
+        q[0] = s / 4.0;
+        q[1] = (r0[1] + r1[0]) / s;
+        q[2] = (r0[2] + r2[0]) / s;
+        q[3] = (r2[1] - r1[2]) / s;
+    } else if (r1[1] > r2[2]) {
+        const double s = sqrt(1.0 + r1[1] - r0[0] - r2[2]) * 2.0;
+        q[0] = (r0[1] + r1[0]) / s;
+        q[1] = s / 4.0;
+        q[2] = (r1[2] + r2[1]) / s;
+        q[3] = (r0[2] - r2[0]) / s;
+    } else {
+        const double s = sqrt(1.0 + r2[2] - r0[0] - r1[1]) * 2.0;
+        q[0] = (r0[2] + r2[0]) / s;
+        q[1] = (r1[2] + r2[1]) / s;
+        q[2] = s / 4.0;
+        q[3] = (r1[0] - r0[1]) / s;
+    }
+}
+
+/// Sets the initial orientation directly from gravity (and the magnetic field, if available), so the filter doesn't
+/// need to converge from the identity.
+static void glfm__initSensorFusion(GLFMSensorFusion *fusion) {
+    // The reference frame axes, in device coordinates. North is in the direction of the magnetic field, and West is
+    // Up x North.
+    double axisX[3], axisY[3];
+    const double *axisZ = fusion->up;
+    bool hasWest = false;
+    if (fusion->hasMagneticField) {
+        glfm__cross3(axisZ, fusion->magneticField, axisY);
+        hasWest = glfm__normalize3(axisY);
+    }
+    if (!hasWest) {
+        const double deviceY[3] = { 0.0, 1.0, 0.0 };
+        const double deviceX[3] = { 1.0, 0.0, 0.0 };
+        glfm__cross3(axisZ, fabs(axisZ[1]) < 0.9 ? deviceY : deviceX, axisY);
+        glfm__normalize3(axisY);
+    }
+    glfm__cross3(axisY, axisZ, axisX);
+
+    // The rows of the device-to-reference rotation matrix are the reference axes
+    glfm__getRotationQuaternion(axisX, axisY, axisZ, fusion->quaternion);
+    fusion->initialized = true;
+}
+
+void glfm__setSensorFusionAcceleration(GLFMSensorFusion *fusion, double x, double y, double z) {
+    fusion->up[0] = -x;
+    fusion->up[1] = -y;
+    fusion->up[2] = -z;
+    fusion->hasUp = glfm__normalize3(fusion->up);
+}
+
+void glfm__setSensorFusionMagneticField(GLFMSensorFusion *fusion, double x, double y, double z) {
+    fusion->magneticField[0] = x;
+    fusion->magneticField[1] = y;
+    fusion->magneticField[2] = z;
+    fusion->hasMagneticField = glfm__normalize3(fusion->magneticField);
+}
+
+bool glfm__updateSensorFusion(GLFMSensorFusion *fusion, double timestamp, double x, double y, double z) {
+    if (!fusion->initialized) {
+        if (!fusion->hasUp) {
+            return false;
+        }
+        glfm__initSensorFusion(fusion);
+        fusion->timestamp = timestamp;
+        return true;
+    }
+    const double dt = timestamp - fusion->timestamp;
+    fusion->timestamp = timestamp;
+    if (dt <= 0.0 || dt > GLFM_SENSOR_FUSION_MAX_INTERVAL) {
+        return false;
+    }
+
+    // Mahony filter, with q0 as the scalar part
+    double q0 = fusion->quaternion[3];
+    double q1 = fusion->quaternion[0];
+    double q2 = fusion->quaternion[1];
+    double q3 = fusion->quaternion[2];
+    double gx = x;
+    double gy = y;
+    double gz = z;
+    if (fusion->hasUp) {
+        const double ax = fusion->up[0];
+        const double ay = fusion->up[1];
+        const double az = fusion->up[2];
+
+        // Estimated direction of up
+        const double halfvx = q1 * q3 - q0 * q2;
+        const double halfvy = q0 * q1 + q2 * q3;
+        const double halfvz = q0 * q0 - 0.5 + q3 * q3;
+
+        // Error is the cross product between the estimated and measured directions
+        double halfex = ay * halfvz - az * halfvy;
+        double halfey = az * halfvx - ax * halfvz;
+        double halfez = ax * halfvy - ay * halfvx;
+
+        if (fusion->hasMagneticField) {
+            const double mx = fusion->magneticField[0];
+            const double my = fusion->magneticField[1];
+            const double mz = fusion->magneticField[2];
+
+            // Reference direction of the magnetic field, in the reference frame
+            const double hx = 2.0 * (mx * (0.5 - q2 * q2 - q3 * q3) + my * (q1 * q2 - q0 * q3) +
+                                     mz * (q1 * q3 + q0 * q2));
+            const double hy = 2.0 * (mx * (q1 * q2 + q0 * q3) + my * (0.5 - q1 * q1 - q3 * q3) +
+                                     mz * (q2 * q3 - q0 * q1));
+            const double bx = sqrt(hx * hx + hy * hy);
+            const double bz = 2.0 * (mx * (q1 * q3 - q0 * q2) + my * (q2 * q3 + q0 * q1) +
+                                     mz * (0.5 - q1 * q1 - q2 * q2));
+
+            // Estimated direction of the magnetic field, in the device frame
+            const double halfwx = bx * (0.5 - q2 * q2 - q3 * q3) + bz * (q1 * q3 - q0 * q2);
+            const double halfwy = bx * (q1 * q2 - q0 * q3) + bz * (q0 * q1 + q2 * q3);
+            const double halfwz = bx * (q0 * q2 + q1 * q3) + bz * (0.5 - q1 * q1 - q2 * q2);
+
+            halfex += my * halfwz - mz * halfwy;
+            halfey += mz * halfwx - mx * halfwz;
+            halfez += mx * halfwy - my * halfwx;
+        }
+
+        // Integral feedback corrects gyroscope bias
+        fusion->integralError[0] += 2.0 * GLFM_SENSOR_FUSION_KI * halfex * dt;
+        fusion->integralError[1] += 2.0 * GLFM_SENSOR_FUSION_KI * halfey * dt;
+        fusion->integralError[2] += 2.0 * GLFM_SENSOR_FUSION_KI * halfez * dt;
+        gx += fusion->integralError[0] + 2.0 * GLFM_SENSOR_FUSION_KP * halfex;
+        gy += fusion->integralError[1] + 2.0 * GLFM_SENSOR_FUSION_KP * halfey;
+        gz += fusion->integralError[2] + 2.0 * GLFM_SENSOR_FUSION_KP * halfez;
+    }
+
+    // Integrate the rate of change of the quaternion
+    gx *= 0.5 * dt;
+    gy *= 0.5 * dt;
+    gz *= 0.5 * dt;
+    const double qa = q0;
+    const double qb = q1;
+    const double qc = q2;
+    q0 += -qb * gx - qc * gy - q3 * gz;
+    q1 += qa * gx + qc * gz - q3 * gy;
+    q2 += qa * gy - qb * gz + q3 * gx;
+    q3 += qa * gz + qb * gy - qc * gx;
+
+    const double length = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    if (length <= 0.0) {
+        glfm__resetSensorFusion(fusion);
+        return false;
+    }
+    fusion->quaternion[0] = q1 / length;
+    fusion->quaternion[1] = q2 / length;
+    fusion->quaternion[2] = q3 / length;
+    fusion->quaternion[3] = q0 / length;
+    return true;
+}
+
+void glfm__getSensorFusionQuaternion(const GLFMSensorFusion *fusion, double quaternion[4]) {
+    quaternion[0] = -fusion->quaternion[0];
+    quaternion[1] = -fusion->quaternion[1];
+    quaternion[2] = -fusion->quaternion[2];
+    quaternion[3] = fusion->quaternion[3];
+}
@@ -0,0 +1,54 @@
+// GLFM
+// https://github.com/brackeen/glfm
+
+#ifndef GLFM_SENSOR_FUSION_H
+#define GLFM_SENSOR_FUSION_H
+
+// Sensor fusion (Mahony filter) that derives the device orientation from accelerometer, gyroscope, and magnetometer
+// samples. Platform-independent and allocation-free, so it can run in a sensor callback and be tested on any host.
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Sensor fusion state. The quaternion (x, y, z, w) rotates the device frame to the reference frame, where the X axis
+/// points North (or an arbitrary horizontal direction without a magnetometer) and the Z axis is up.
+typedef struct {
+    double quaternion[4];
+    double integralError[3];
+    double up[3];
+    double magneticField[3];
+    double timestamp;
+    bool hasUp;
+    bool hasMagneticField;
+    bool initialized;
+} GLFMSensorFusion;
+
+/// Resets the filter to its initial state.
+void glfm__resetSensorFusion(GLFMSensorFusion *fusion);
+
+/// Sets the latest accelerometer sample, in G's. As with ``GLFMSensorAccelerometer``, the acceleration points down at
+/// rest.
+void glfm__setSensorFusionAcceleration(GLFMSensorFusion *fusion, double x, double y, double z);
+
+/// Sets the latest magnetometer sample. Only the direction is used, so the units don't matter.
+void glfm__setSensorFusionMagneticField(GLFMSensorFusion *fusion, double x, double y, double z);
+
+/// Integrates a gyroscope sample, in radians per second, using the latest accelerometer and magnetometer samples to
+/// correct drift. The timestamp is in seconds.
+///
+/// Returns true if the orientation was updated. The first gyroscope sample after the first accelerometer sample
+/// initializes the orientation directly from gravity (and the magnetic field, if available).
+bool glfm__updateSensorFusion(GLFMSensorFusion *fusion, double timestamp, double x, double y, double z);
+
+/// Gets the orientation as a unit quaternion (x, y, z, w), in the same convention as the ``GLFMSensorRotationMatrix``
+/// matrix (the inverse of the filter's device-to-reference rotation).
+void glfm__getSensorFusionQuaternion(const GLFMSensorFusion *fusion, double quaternion[4]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,6 +5,7 @@
 # Android: Requires ANDROID_NDK_HOME set.
 # Apple: Requires xcodebuild.
 # Emscripten: Requires emcmake in the path.
+# Unit tests: Require a C compiler for the host system, and python3.
 #
 # For verbose mode, use:
 # ./build_all.sh -v
@@ -52,6 +53,8 @@ run_test() {
     fi
 }
 
+run_test ./build_unit_tests.sh
+
 if [ -z "${ANDROID_NDK_HOME}" ]; then
     echo "./build_android.sh: Skipped (ANDROID_NDK_HOME not set)"
 else
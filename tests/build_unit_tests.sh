@@ -0,0 +1,21 @@
+#!/bin/sh
+
+if ! type cmake > /dev/null 2>&1; then
+    echo "Error: cmake not found"
+    exit 1
+fi
+
+if ! type python3 > /dev/null 2>&1; then
+    echo "Error: python3 not found"
+    exit 1
+fi
+
+./gen_keyboard_tables.py --check || exit $?
+
+export CFLAGS=-Werror
+
+rm -rf build/unit
+cmake -S unit -B build/unit \
+    -D CMAKE_VERBOSE_MAKEFILE=ON || exit $?
+cmake --build build/unit || exit $?
+cd build/unit && ctest --output-on-failure
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+#
+# Generates the perfect hash tables for KeyboardEvent.code and KeyboardEvent.key values in src/glfm_keyboard_tables.h.
+#
+# Usage:
+# ./gen_keyboard_tables.py          Rewrites the generated tables in src/glfm_keyboard_tables.h.
+# ./gen_keyboard_tables.py --check  Exits with an error if the generated tables are out of date.
+#
+# The tables use "hash and displace": a value is hashed once to find its bucket, and hashed again with the bucket's
+# seed to find its slot. The hash function must match glfm__keyboardHash() in src/glfm_keyboard_tables.h.
+
+import os
+import sys
+
+# KeyboardEvent.code values, from https://www.w3.org/TR/uievents-code/ (Added functions keys F13-F24)
+# egrep -o '<code class="code" id="code-.*?</code>' uievents-code.html | sort | awk -F"[><]" '{print $3}' | awk 1 ORS=', '
+KEYBOARD_EVENT_CODES = {
+    "AltLeft": "GLFMKeyCodeAltLeft", "AltRight": "GLFMKeyCodeAltRight",
+    "ArrowDown": "GLFMKeyCodeArrowDown", "ArrowLeft": "GLFMKeyCodeArrowLeft",
+    "ArrowRight": "GLFMKeyCodeArrowRight", "ArrowUp": "GLFMKeyCodeArrowUp",
+    "Backquote": "GLFMKeyCodeBackquote", "Backslash": "GLFMKeyCodeBackslash", "Backspace": "GLFMKeyCodeBackspace",
+    "BracketLeft": "GLFMKeyCodeBracketLeft", "BracketRight": "GLFMKeyCodeBracketRight",
+    "BrowserBack": "GLFMKeyCodeNavigationBack", "CapsLock": "GLFMKeyCodeCapsLock", "Comma": "GLFMKeyCodeComma",
+    "ContextMenu": "GLFMKeyCodeMenu", "ControlLeft": "GLFMKeyCodeControlLeft",
+    "ControlRight": "GLFMKeyCodeControlRight", "Delete": "GLFMKeyCodeDelete",
+    "Digit0": "GLFMKeyCode0", "Digit1": "GLFMKeyCode1", "Digit2": "GLFMKeyCode2", "Digit3": "GLFMKeyCode3",
+    "Digit4": "GLFMKeyCode4", "Digit5": "GLFMKeyCode5", "Digit6": "GLFMKeyCode6", "Digit7": "GLFMKeyCode7",
+    "Digit8": "GLFMKeyCode8", "Digit9": "GLFMKeyCode9",
+    "End": "GLFMKeyCodeEnd", "Enter": "GLFMKeyCodeEnter", "Equal": "GLFMKeyCodeEqual", "Escape": "GLFMKeyCodeEscape",
+    "F1": "GLFMKeyCodeF1", "F2": "GLFMKeyCodeF2", "F3": "GLFMKeyCodeF3", "F4": "GLFMKeyCodeF4",
+    "F5": "GLFMKeyCodeF5", "F6": "GLFMKeyCodeF6", "F7": "GLFMKeyCodeF7", "F8": "GLFMKeyCodeF8",
+    "F9": "GLFMKeyCodeF9", "F10": "GLFMKeyCodeF10", "F11": "GLFMKeyCodeF11", "F12": "GLFMKeyCodeF12",
+    "F13": "GLFMKeyCodeF13", "F14": "GLFMKeyCodeF14", "F15": "GLFMKeyCodeF15", "F16": "GLFMKeyCodeF16",
+    "F17": "GLFMKeyCodeF17", "F18": "GLFMKeyCodeF18", "F19": "GLFMKeyCodeF19", "F20": "GLFMKeyCodeF20",
+    "F21": "GLFMKeyCodeF21", "F22": "GLFMKeyCodeF22", "F23": "GLFMKeyCodeF23", "F24": "GLFMKeyCodeF24",
+    "Fn": "GLFMKeyCodeFunction", "Help": "GLFMKeyCodeInsert", "Home": "GLFMKeyCodeHome",
+    "Insert": "GLFMKeyCodeInsert",
+    "KeyA": "GLFMKeyCodeA", "KeyB": "GLFMKeyCodeB", "KeyC": "GLFMKeyCodeC", "KeyD": "GLFMKeyCodeD",
+    "KeyE": "GLFMKeyCodeE", "KeyF": "GLFMKeyCodeF", "KeyG": "GLFMKeyCodeG", "KeyH": "GLFMKeyCodeH",
+    "KeyI": "GLFMKeyCodeI", "KeyJ": "GLFMKeyCodeJ", "KeyK": "GLFMKeyCodeK", "KeyL": "GLFMKeyCodeL",
+    "KeyM": "GLFMKeyCodeM", "KeyN": "GLFMKeyCodeN", "KeyO": "GLFMKeyCodeO", "KeyP": "GLFMKeyCodeP",
+    "KeyQ": "GLFMKeyCodeQ", "KeyR": "GLFMKeyCodeR", "KeyS": "GLFMKeyCodeS", "KeyT": "GLFMKeyCodeT",
+    "KeyU": "GLFMKeyCodeU", "KeyV": "GLFMKeyCodeV", "KeyW": "GLFMKeyCodeW", "KeyX": "GLFMKeyCodeX",
+    "KeyY": "GLFMKeyCodeY", "KeyZ": "GLFMKeyCodeZ",
+    "MediaPlayPause": "GLFMKeyCodeMediaPlayPause", "MetaLeft": "GLFMKeyCodeMetaLeft",
+    "MetaRight": "GLFMKeyCodeMetaRight", "Minus": "GLFMKeyCodeMinus", "NumLock": "GLFMKeyCodeNumLock",
+    "Numpad0": "GLFMKeyCodeNumpad0", "Numpad1": "GLFMKeyCodeNumpad1", "Numpad2": "GLFMKeyCodeNumpad2",
+    "Numpad3": "GLFMKeyCodeNumpad3", "Numpad4": "GLFMKeyCodeNumpad4", "Numpad5": "GLFMKeyCodeNumpad5",
+    "Numpad6": "GLFMKeyCodeNumpad6", "Numpad7": "GLFMKeyCodeNumpad7", "Numpad8": "GLFMKeyCodeNumpad8",
+    "Numpad9": "GLFMKeyCodeNumpad9", "NumpadAdd": "GLFMKeyCodeNumpadAdd",
+    "NumpadDecimal": "GLFMKeyCodeNumpadDecimal", "NumpadDivide": "GLFMKeyCodeNumpadDivide",
+    "NumpadEnter": "GLFMKeyCodeNumpadEnter", "NumpadEqual": "GLFMKeyCodeNumpadEqual",
+    "NumpadMultiply": "GLFMKeyCodeNumpadMultiply", "NumpadSubtract": "GLFMKeyCodeNumpadSubtract",
+    "PageDown": "GLFMKeyCodePageDown", "PageUp": "GLFMKeyCodePageUp", "Pause": "GLFMKeyCodePause",
+    "Period": "GLFMKeyCodePeriod", "Power": "GLFMKeyCodePower", "PrintScreen": "GLFMKeyCodePrintScreen",
+    "Quote": "GLFMKeyCodeQuote", "ScrollLock": "GLFMKeyCodeScrollLock", "Semicolon": "GLFMKeyCodeSemicolon",
+    "ShiftLeft": "GLFMKeyCodeShiftLeft", "ShiftRight": "GLFMKeyCodeShiftRight", "Slash": "GLFMKeyCodeSlash",
+    "Space": "GLFMKeyCodeSpace", "Tab": "GLFMKeyCodeTab",
+}
+
+# Pre-defined KeyboardEvent.key values, from https://www.w3.org/TR/uievents-key/
+# (Added functions keys F13-F24 and Soft5-Soft10)
+# egrep -o '<code class="key" id="key-.*?</code>' uievents-key.html | sort | awk -F"[><]" '{print $3}' | awk 1 ORS=', '
+KEYBOARD_EVENT_KEYS = [
+    "AVRInput", "AVRPower", "Accept", "Again", "AllCandidates", "Alphanumeric", "Alt", "AltGraph", "AppSwitch",
+    "ArrowDown", "ArrowLeft", "ArrowRight", "ArrowUp", "Attn", "AudioBalanceLeft", "AudioBalanceRight",
+    "AudioBassBoostDown", "AudioBassBoostToggle", "AudioBassBoostUp", "AudioFaderFront", "AudioFaderRear",
+    "AudioSurroundModeNext", "AudioTrebleDown", "AudioTrebleUp", "AudioVolumeDown", "AudioVolumeMute", "AudioVolumeUp",
+    "Backspace", "BrightnessDown", "BrightnessUp", "BrowserBack", "BrowserFavorites", "BrowserForward", "BrowserHome",
+    "BrowserRefresh", "BrowserSearch", "BrowserStop", "Call", "Camera", "CameraFocus", "Cancel", "CapsLock",
+    "ChannelDown", "ChannelUp", "Clear", "Close", "ClosedCaptionToggle", "CodeInput", "ColorF0Red", "ColorF1Green",
+    "ColorF2Yellow", "ColorF3Blue", "ColorF4Grey", "ColorF5Brown", "Compose", "ContextMenu", "Control", "Convert",
+    "Copy", "CrSel", "Cut", "DVR", "Dead", "Delete", "Dimmer", "DisplaySwap", "Eisu", "Eject", "End", "EndCall",
+    "Enter", "EraseEof", "Escape", "ExSel", "Execute", "Exit", "F1", "F10", "F11", "F12", "F13", "F14", "F15", "F16",
+    "F17", "F18", "F19", "F2", "F20", "F21", "F22", "F23", "F24", "F3", "F4", "F5", "F6", "F7", "F8", "F9",
+    "FavoriteClear0", "FavoriteClear1", "FavoriteClear2", "FavoriteClear3", "FavoriteRecall0", "FavoriteRecall1",
+    "FavoriteRecall2", "FavoriteRecall3", "FavoriteStore0", "FavoriteStore1", "FavoriteStore2", "FavoriteStore3",
+    "FinalMode", "Find", "Fn", "FnLock", "GoBack", "GoHome", "GroupFirst", "GroupLast", "GroupNext", "GroupPrevious",
+    "Guide", "GuideNextDay", "GuidePreviousDay", "HangulMode", "HanjaMode", "Hankaku", "HeadsetHook", "Help",
+    "Hibernate", "Hiragana", "HiraganaKatakana", "Home", "Hyper", "Info", "Insert", "InstantReplay", "JunjaMode",
+    "KanaMode", "KanjiMode", "Katakana", "Key11", "Key12", "LastNumberRedial", "LaunchApplication1",
+    "LaunchApplication2", "LaunchCalendar", "LaunchContacts", "LaunchMail", "LaunchMediaPlayer", "LaunchMusicPlayer",
+    "LaunchPhone", "LaunchScreenSaver", "LaunchSpreadsheet", "LaunchWebBrowser", "LaunchWebCam", "LaunchWordProcessor",
+    "Link", "ListProgram", "LiveContent", "Lock", "LogOff", "MailForward", "MailReply", "MailSend", "MannerMode",
+    "MediaApps", "MediaAudioTrack", "MediaClose", "MediaFastForward", "MediaLast", "MediaPause", "MediaPlay",
+    "MediaPlayPause", "MediaRecord", "MediaRewind", "MediaSkipBackward", "MediaSkipForward", "MediaStepBackward",
+    "MediaStepForward", "MediaStop", "MediaTopMenu", "MediaTrackNext", "MediaTrackPrevious", "Meta",
+    "MicrophoneToggle", "MicrophoneVolumeDown", "MicrophoneVolumeMute", "MicrophoneVolumeUp", "ModeChange",
+    "NavigateIn", "NavigateNext", "NavigateOut", "NavigatePrevious", "New", "NextCandidate", "NextFavoriteChannel",
+    "NextUserProfile", "NonConvert", "Notification", "NumLock", "OnDemand", "Open", "PageDown", "PageUp", "Pairing",
+    "Paste", "Pause", "PinPDown", "PinPMove", "PinPToggle", "PinPUp", "Play", "PlaySpeedDown", "PlaySpeedReset",
+    "PlaySpeedUp", "Power", "PowerOff", "PreviousCandidate", "Print", "PrintScreen", "Process", "Props",
+    "RandomToggle", "RcLowBattery", "RecordSpeedNext", "Redo", "RfBypass", "Romaji", "STBInput", "STBPower", "Save",
+    "ScanChannelsToggle", "ScreenModeNext", "ScrollLock", "Select", "Settings", "Shift", "SingleCandidate", "Soft1",
+    "Soft10", "Soft2", "Soft3", "Soft4", "Soft5", "Soft6", "Soft7", "Soft8", "Soft9", "SpeechCorrectionList",
+    "SpeechInputToggle", "SpellCheck", "SplitScreenToggle", "Standby", "Subtitle", "Super", "Symbol", "SymbolLock",
+    "TV", "TV3DMode", "TVAntennaCable", "TVAudioDescription", "TVAudioDescriptionMixDown", "TVAudioDescriptionMixUp",
+    "TVContentsMenu", "TVDataService", "TVInput", "TVInputComponent1", "TVInputComponent2", "TVInputComposite1",
+    "TVInputComposite2", "TVInputHDMI1", "TVInputHDMI2", "TVInputHDMI3", "TVInputHDMI4", "TVInputVGA1",
+    "TVMediaContext", "TVNetwork", "TVNumberEntry", "TVPower", "TVRadioService", "TVSatellite", "TVSatelliteBS",
+    "TVSatelliteCS", "TVSatelliteToggle", "TVTerrestrialAnalog", "TVTerrestrialDigital", "TVTimer", "Tab", "Teletext",
+    "Undo", "Unidentified", "VideoModeNext", "VoiceDial", "WakeUp", "Wink", "Zenkaku", "ZenkakuHankaku", "ZoomIn",
+    "ZoomOut", "ZoomToggle",
+]
+
+SOURCE_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "glfm_keyboard_tables.h")
+BEGIN_MARKER = "// BEGIN GENERATED KEYBOARD TABLES (tests/gen_keyboard_tables.py)\n"
+END_MARKER = "// END GENERATED KEYBOARD TABLES\n"
+MAX_SEED = 0xFFFF
+MAX_LINE_LENGTH = 120
+
+
+def keyboard_hash(string, seed):
+    """Same as glfm__keyboardHash(): FNV-1a with the seed mixed into the offset basis."""
+    h = (2166136261 ^ seed) & 0xFFFFFFFF
+    for c in string.encode("utf-8"):
+        h ^= c
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h ^ (h >> 16)
+
+
+def build_perfect_hash(names, bucket_count, slot_count):
+    """Returns (seeds, slots), where slots[keyboard_hash(name, seeds[bucket]) % slot_count] == name."""
+    buckets = [[] for _ in range(bucket_count)]
+    for name in names:
+        buckets[keyboard_hash(name, 0) % bucket_count].append(name)
+    seeds = [0] * bucket_count
+    slots = [None] * slot_count
+    # Place the largest buckets first, while there are the most free slots.
+    for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[bucket]:
+            continue
+        for seed in range(1, MAX_SEED + 1):
+            indices = [keyboard_hash(name, seed) % slot_count for name in buckets[bucket]]
+            if len(set(indices)) == len(indices) and all(slots[i] is None for i in indices):
+                seeds[bucket] = seed
+                for name, i in zip(buckets[bucket], indices):
+                    slots[i] = name
+                break
+        else:
+            sys.exit("Error: no seed found for bucket %d. Try more buckets or slots." % bucket)
+    return seeds, slots
+
+
+def wrap(items, indent="    "):
+    lines = []
+    line = indent
+    for item in items:
+        if len(line) + len(item) + 1 > MAX_LINE_LENGTH and line.strip():
+            lines.append(line.rstrip())
+            line = indent
+        line += item + " "
+    if line.strip():
+        lines.append(line.rstrip())
+    return "\n".join(lines) + "\n"
+
+
+def generate():
+    codes = sorted(KEYBOARD_EVENT_CODES)
+    code_buckets = (len(codes) + 3) // 4
+    code_slots = 128
+    code_seeds, code_table = build_perfect_hash(codes, code_buckets, code_slots)
+
+    keys = sorted(KEYBOARD_EVENT_KEYS)
+    key_buckets = (len(keys) + 3) // 4
+    key_slots = 512
+    key_seeds, key_table = build_perfect_hash(keys, key_buckets, key_slots)
+
+    out = BEGIN_MARKER
+    out += "\n"
+    out += "#define GLFM_KEYBOARD_CODE_BUCKETS %d\n" % code_buckets
+    out += "#define GLFM_KEYBOARD_CODE_SLOTS %d\n" % code_slots
+    out += "#define GLFM_KEYBOARD_KEY_BUCKETS %d\n" % key_buckets
+    out += "#define GLFM_KEYBOARD_KEY_SLOTS %d\n" % key_slots
+    out += "\n"
+    out += "typedef struct {\n    const char *code;\n    GLFMKeyCode keyCode;\n} GLFMKeyboardCode;\n"
+    out += "\n"
+    out += "static const uint16_t GLFM_KEYBOARD_CODE_SEEDS[GLFM_KEYBOARD_CODE_BUCKETS] = {\n"
+    out += wrap("%d," % seed for seed in code_seeds)
+    out += "};\n\n"
+    out += "static const GLFMKeyboardCode GLFM_KEYBOARD_CODES[GLFM_KEYBOARD_CODE_SLOTS] = {\n"
+    out += wrap('[%d] = { "%s", %s },' % (i, name, KEYBOARD_EVENT_CODES[name])
+                for i, name in enumerate(code_table) if name is not None)
+    out += "};\n\n"
+    out += "static const uint16_t GLFM_KEYBOARD_KEY_SEEDS[GLFM_KEYBOARD_KEY_BUCKETS] = {\n"
+    out += wrap("%d," % seed for seed in key_seeds)
+    out += "};\n\n"
+    out += "static const char *GLFM_KEYBOARD_KEYS[GLFM_KEYBOARD_KEY_SLOTS] = {\n"
+    out += wrap('[%d] = "%s",' % (i, name) for i, name in enumerate(key_table) if name is not None)
+    out += "};\n"
+    out += "\n"
+    out += END_MARKER
+    return out
+
+
+def main():
+    with open(SOURCE_PATH, "r", encoding="utf-8", newline="") as f:
+        source = f.read()
+    begin = source.find(BEGIN_MARKER)
+    end = source.find(END_MARKER)
+    if begin < 0 or end < begin:
+        sys.exit("Error: generated table markers not found in " + SOURCE_PATH)
+    new_source = source[:begin] + generate() + source[end + len(END_MARKER):]
+    if len(sys.argv) > 1 and sys.argv[1] == "--check":
+        if new_source != source:
+            sys.exit("Error: keyboard tables are out of date. Run ./gen_keyboard_tables.py")
+        print("Keyboard tables are up to date")
+    elif new_source != source:
+        with open(SOURCE_PATH, "w", encoding="utf-8", newline="") as f:
+            f.write(new_source)
+        print("Updated " + SOURCE_PATH)
+
+
+if __name__ == "__main__":
+    main()
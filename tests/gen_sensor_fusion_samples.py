@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+#
+# Generates the sensor sample files in tests/unit/data/ used by tests/unit/sensor_fusion_test.c.
+#
+# Usage:
+# ./gen_sensor_fusion_samples.py
+#
+# Each file is a capture of a device following a known motion: accelerometer (G's), gyroscope (radians/second), and
+# magnetometer (microteslas) samples in device coordinates, with sensor noise and a constant gyroscope bias. The files
+# also contain the true orientation at regular intervals, as a quaternion in the GLFMSensorRotationMatrix convention.
+#
+# File format, one record per line ("#" starts a comment):
+#   a,timestamp,x,y,z    Accelerometer sample
+#   g,timestamp,x,y,z    Gyroscope sample
+#   m,timestamp,x,y,z    Magnetometer sample
+#   q,timestamp,x,y,z,w  Expected orientation after all previous samples
+#
+# The reference frame has X pointing North, Y pointing West, and Z pointing up. The device starts flat, face up, with
+# its Y axis pointing North (the same heading sensor fusion chooses when there is no magnetometer).
+
+import math
+import os
+import random
+
+SAMPLE_RATE = 100
+MAGNETOMETER_RATE = 50
+EXPECTED_INTERVAL = 0.25
+MAGNETIC_FIELD = (20.0, 0.0, -40.0)  # North and down
+GYROSCOPE_BIAS = (0.004, -0.003, 0.002)
+ACCELEROMETER_NOISE = 0.01
+GYROSCOPE_NOISE = 0.005
+MAGNETOMETER_NOISE = 0.5
+
+# Motions: (duration in seconds, angular velocity in device coordinates, in radians/second)
+QUARTER_TURN = math.pi / 2
+MOTIONS = [
+    (1.0, (0.0, 0.0, 0.0)),
+    (2.0, (0.0, 0.0, QUARTER_TURN / 2.0)),  # Turn left 90 degrees
+    (1.0, (0.0, 0.0, 0.0)),
+    (2.0, (QUARTER_TURN / 2.0, 0.0, 0.0)),  # Tilt upright (portrait)
+    (1.0, (0.0, 0.0, 0.0)),
+    (1.5, (0.0, QUARTER_TURN / 3.0, 0.0)),  # Roll 45 degrees
+    (1.0, (0.0, 0.0, 0.0)),
+    (2.0, (-QUARTER_TURN / 4.0, 0.0, -QUARTER_TURN / 4.0)),
+    (2.0, (0.0, 0.0, 0.0)),
+]
+
+
+def quaternion_multiply(a, b):
+    ax, ay, az, aw = a
+    bx, by, bz, bw = b
+    return (aw * bx + ax * bw + ay * bz - az * by,
+            aw * by - ax * bz + ay * bw + az * bx,
+            aw * bz + ax * by - ay * bx + az * bw,
+            aw * bw - ax * bx - ay * by - az * bz)
+
+
+def quaternion_normalize(q):
+    length = math.sqrt(sum(v * v for v in q))
+    return tuple(v / length for v in q)
+
+
+def quaternion_conjugate(q):
+    return (-q[0], -q[1], -q[2], q[3])
+
+
+def quaternion_rotate(q, v):
+    x, y, z, _ = quaternion_multiply(quaternion_multiply(q, (v[0], v[1], v[2], 0.0)), quaternion_conjugate(q))
+    return (x, y, z)
+
+
+def axis_angle_quaternion(omega, dt):
+    rate = math.sqrt(sum(v * v for v in omega))
+    if rate <= 0.0:
+        return (0.0, 0.0, 0.0, 1.0)
+    half_angle = rate * dt / 2.0
+    scale = math.sin(half_angle) / rate
+    return (omega[0] * scale, omega[1] * scale, omega[2] * scale, math.cos(half_angle))
+
+
+def generate(path, include_magnetometer, seed):
+    rng = random.Random(seed)
+
+    def noisy(vector, noise, bias=(0.0, 0.0, 0.0)):
+        return tuple(v + b + rng.gauss(0.0, noise) for v, b in zip(vector, bias))
+
+    # Device-to-reference rotation: device X is East, device Y is North, device Z is up
+    orientation = quaternion_normalize((0.0, 0.0, math.sin(-math.pi / 4), math.cos(-math.pi / 4)))
+    lines = [
+        "# Generated by tests/gen_sensor_fusion_samples.py",
+        "# Magnetometer: " + ("yes" if include_magnetometer else "no"),
+    ]
+
+    def record(kind, time, values):
+        lines.append(kind + "," + ",".join("%.6f" % v for v in (time,) + tuple(values)))
+
+    def record_sensors(time, sample, omega):
+        device_from_reference = quaternion_conjugate(orientation)
+        accel = quaternion_rotate(device_from_reference, (0.0, 0.0, -1.0))
+        record("a", time, noisy(accel, ACCELEROMETER_NOISE))
+        if include_magnetometer and sample % (SAMPLE_RATE // MAGNETOMETER_RATE) == 0:
+            field = quaternion_rotate(device_from_reference, MAGNETIC_FIELD)
+            record("m", time, noisy(field, MAGNETOMETER_NOISE))
+        record("g", time, noisy(omega, GYROSCOPE_NOISE, GYROSCOPE_BIAS))
+        if sample % int(EXPECTED_INTERVAL * SAMPLE_RATE) == 0:
+            record("q", time, quaternion_conjugate(orientation))
+
+    dt = 1.0 / SAMPLE_RATE
+    sample = 0
+    time = 0.0
+    omega = (0.0, 0.0, 0.0)
+    record_sensors(time, sample, omega)
+    for duration, omega in MOTIONS:
+        for _ in range(int(round(duration * SAMPLE_RATE))):
+            # Device-frame angular velocity: q' = q * exp(omega * dt / 2)
+            orientation = quaternion_normalize(quaternion_multiply(orientation, axis_angle_quaternion(omega, dt)))
+            sample += 1
+            time = sample * dt
+            record_sensors(time, sample, omega)
+
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    data_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "unit", "data")
+    os.makedirs(data_dir, exist_ok=True)
+    generate(os.path.join(data_dir, "sensor_fusion_motion.csv"), True, 1)
+    generate(os.path.join(data_dir, "sensor_fusion_motion_no_magnetometer.csv"), False, 2)
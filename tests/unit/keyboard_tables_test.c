@@ -0,0 +1,78 @@
+// GLFM
+// https://github.com/brackeen/glfm
+//
+// Checks that every entry in the keyboard event tables can be found, and that unknown values are not found. See
+// tests/gen_keyboard_tables.py.
+//
+// Usage: glfm_keyboard_tables_test
+
+#include "glfm_keyboard_tables.h"
+
+#include <stdio.h>
+
+int main(void) {
+    int failures = 0;
+    int codeCount = 0;
+    int keyCount = 0;
+
+    // Every entry is found at its own slot
+    for (int i = 0; i < GLFM_KEYBOARD_CODE_SLOTS; i++) {
+        const GLFMKeyboardCode *entry = &GLFM_KEYBOARD_CODES[i];
+        if (entry->code) {
+            codeCount++;
+            if (glfm__getKeyCode(entry->code) != entry->keyCode) {
+                printf("Failure: KeyboardEvent.code \"%s\" not found\n", entry->code);
+                failures++;
+            }
+        }
+    }
+    for (int i = 0; i < GLFM_KEYBOARD_KEY_SLOTS; i++) {
+        const char *entry = GLFM_KEYBOARD_KEYS[i];
+        if (entry) {
+            keyCount++;
+            if (!glfm__isPredefinedKey(entry)) {
+                printf("Failure: KeyboardEvent.key \"%s\" not found\n", entry);
+                failures++;
+            }
+        }
+    }
+    if (codeCount == 0 || keyCount == 0) {
+        printf("Failure: Keyboard event tables are empty\n");
+        failures++;
+    }
+
+    // Known values
+    if (glfm__getKeyCode("KeyA") != GLFMKeyCodeA || glfm__getKeyCode("Enter") != GLFMKeyCodeEnter ||
+        glfm__getKeyCode("NumpadEnter") != GLFMKeyCodeNumpadEnter) {
+        printf("Failure: KeyboardEvent.code values have the wrong key code\n");
+        failures++;
+    }
+    if (!glfm__isPredefinedKey("Enter") || !glfm__isPredefinedKey("ArrowLeft") || !glfm__isPredefinedKey("F24")) {
+        printf("Failure: Pre-defined KeyboardEvent.key values not found\n");
+        failures++;
+    }
+
+    // Unknown values, including prefixes and near-misses of table entries
+    static const char *unknownCodes[] = { "", "KeyNotFound", "Key", "keya", "KeyAA", "F25", "a" };
+    static const char *unknownKeys[] = { "", "a", "A", " ", "1", "\xc3\xa9", "Arrow", "enter", "F25", "KeyA" };
+    for (size_t i = 0; i < sizeof(unknownCodes) / sizeof(*unknownCodes); i++) {
+        if (glfm__getKeyCode(unknownCodes[i]) != GLFMKeyCodeUnknown) {
+            printf("Failure: Unknown KeyboardEvent.code \"%s\" found\n", unknownCodes[i]);
+            failures++;
+        }
+    }
+    for (size_t i = 0; i < sizeof(unknownKeys) / sizeof(*unknownKeys); i++) {
+        if (glfm__isPredefinedKey(unknownKeys[i])) {
+            printf("Failure: Unknown KeyboardEvent.key \"%s\" found\n", unknownKeys[i]);
+            failures++;
+        }
+    }
+
+    printf("%i KeyboardEvent.code values, %i KeyboardEvent.key values\n", codeCount, keyCount);
+    if (failures > 0) {
+        printf("Failure: %i failed checks\n", failures);
+        return 1;
+    }
+    printf("Success: Keyboard event tables\n");
+    return 0;
+}
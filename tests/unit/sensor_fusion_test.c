@@ -0,0 +1,98 @@
+// GLFM
+// https://github.com/brackeen/glfm
+//
+// Replays recorded sensor samples through the sensor fusion filter, and checks the orientation against the expected
+// orientation in the file. See tests/gen_sensor_fusion_samples.py for the file format.
+//
+// Usage: glfm_sensor_fusion_test file.csv [file.csv ...]
+
+#include "glfm_sensor_fusion.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#define MAX_ERROR_DEGREES 4.0
+#define DEGREES_PER_RADIAN (180.0 / 3.14159265358979323846)
+
+/// Returns the angle, in degrees, between the rotations of two unit quaternions.
+static double angleBetween(const double a[4], const double b[4]) {
+    double dot = fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+    if (dot > 1.0) {
+        dot = 1.0;
+    }
+    return 2.0 * acos(dot) * DEGREES_PER_RADIAN;
+}
+
+static int testFile(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        printf("Failure: Couldn't open %s\n", path);
+        return 1;
+    }
+
+    GLFMSensorFusion fusion;
+    glfm__resetSensorFusion(&fusion);
+
+    char line[256];
+    int lineNumber = 0;
+    int checks = 0;
+    int failures = 0;
+    double maxError = 0.0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        char kind = 0;
+        double t, v[4];
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        int count = sscanf(line, "%c,%lf,%lf,%lf,%lf,%lf", &kind, &t, &v[0], &v[1], &v[2], &v[3]);
+        if (kind == 'a' && count == 5) {
+            glfm__setSensorFusionAcceleration(&fusion, v[0], v[1], v[2]);
+        } else if (kind == 'm' && count == 5) {
+            glfm__setSensorFusionMagneticField(&fusion, v[0], v[1], v[2]);
+        } else if (kind == 'g' && count == 5) {
+            glfm__updateSensorFusion(&fusion, t, v[0], v[1], v[2]);
+        } else if (kind == 'q' && count == 6) {
+            double quaternion[4];
+            glfm__getSensorFusionQuaternion(&fusion, quaternion);
+            const double error = angleBetween(quaternion, v);
+            if (error > maxError) {
+                maxError = error;
+            }
+            if (!fusion.initialized || error > MAX_ERROR_DEGREES) {
+                printf("Failure: %s:%i: at %.2fs, orientation is %.2f degrees from the expected orientation\n",
+                       path, lineNumber, t, error);
+                failures++;
+            }
+            checks++;
+        } else {
+            printf("Failure: %s:%i: invalid record\n", path, lineNumber);
+            failures++;
+        }
+    }
+    fclose(file);
+
+    if (checks == 0) {
+        printf("Failure: %s: no expected orientations\n", path);
+        failures++;
+    }
+    printf("%s: %i checks, max error %.2f degrees\n", path, checks, maxError);
+    return failures;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("Usage: %s file.csv [file.csv ...]\n", argv[0]);
+        return 1;
+    }
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        failures += testFile(argv[i]);
+    }
+    if (failures > 0) {
+        printf("Failure: %i failed checks\n", failures);
+        return 1;
+    }
+    printf("Success: Sensor fusion\n");
+    return 0;
+}